@@ -95,6 +95,25 @@ int main(void)
     dll_for_each(my_list, print_dll, NULL);
     putchar('\n');
 
+    printf("\n****************\n");
+    dll_push_front_take(my_list, ret_1);
+    dll_push_back_take(my_list, ret_2);
+    printf("The popped elements were returned to the list:\n");
+    dll_for_each(my_list, print_dll, NULL);
+    putchar('\n');
+    float *ret_3 = dll_extract_at(my_list, 1);
+    printf("Dll extract at 1: %.1f\n", *ret_3);
+    free_item(ret_3);
+
+    printf("\n****************\n");
+    dll_clear_deferred(my_list);
+    printf("The list was cleared, list size: %zu\n", dll_size(my_list));
+    dll_push_back(my_list, &z);
+    dll_for_each(my_list, print_dll, NULL);
+    putchar('\n');
+    while (dll_reclaim(my_list, 2) > 0)
+        printf("Two nodes have been reclaimed.\n");
+
     dll_destroy(my_list);
 
     return 0;
@@ -0,0 +1,649 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <doubly_linked_list.h>
+
+/*
+ * Differential fuzz driver: applies random sequences of dll_* calls to a
+ * list and to a plain array model of it, and after every step checks that
+ * both hold the same elements in the same order and that the links, the
+ * size and the limiters of the list are consistent.
+ *
+ * Usage: fuzz_driver [seed] [steps]
+ *
+ * Build with -DDLL_ENABLE_SANITIZERS=ON to run it under ASan and UBSan.
+ */
+
+#define MAX_ITEMS 256
+#define MAX_KEY 16
+#define MERGE_LISTS 3
+#define DUPLICATE_ITEMS 20000
+#define DUPLICATE_KEYS 4
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+typedef struct {
+    int key;                ///< Sorting key (small, so that duplicates are common).
+    int seq;                ///< Unique number that tells equal keys apart.
+} Item;
+
+typedef struct {
+    DllList *list;          ///< The list under test.
+    Item items[MAX_ITEMS + MAX_ITEMS * MERGE_LISTS];  ///< The model of the list.
+    size_t size;            ///< Number of items in the model.
+    size_t capacity;        ///< Capacity of the list, '0' if unlimited.
+    bool owns_data;         ///< The list was created with 'copy' and 'destroy'.
+    bool sorted;            ///< The list is expected to be in sorted mode.
+    const char *op;         ///< Name of the operation being checked.
+    unsigned long step;     ///< Number of the step being checked.
+} Model;
+
+void *copy_item(const void *item);
+void free_item(void *item);
+int cmp(const void *item_1, const void *item_2);
+void sum_item(void *data, void *arg);
+void count_item(void *data, void *arg);
+void check(bool condition, const char *text, int line);
+Item *new_item(Model *model, bool owned);
+Item next_item(void);
+DllList *create_list(const Model *model);
+void check_list(const Model *model);
+void check_same(const DllList *list, const Item *items, size_t size);
+void model_insert(Model *model, size_t index, Item item);
+void model_remove(Model *model, size_t index);
+void model_sort(Item *items, size_t size);
+void release(const Model *model, Item *item);
+void run_step(Model *model);
+void run(unsigned long seed, unsigned long steps, int variant);
+void run_duplicates(unsigned long seed);
+
+static Model *current_model = NULL;
+static int next_seq = 0;
+static unsigned long cmp_calls = 0;
+
+/* Items handed to lists that do not own their data. */
+static Item pool[1 << 20];
+static size_t pool_used = 0;
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1;
+    unsigned long steps = (argc > 2) ? strtoul(argv[2], NULL, 10) : 20000;
+
+    /* Variants: 0 - owned data, 1 - borrowed data, 2 - deque,
+     * 3 - deque with a capacity, 4 - sorted mode. */
+    for (int variant = 0; variant < 5; ++variant)
+    {
+        run(seed, steps, variant);
+        printf("variant %d: %lu steps passed\n", variant, steps);
+    }
+    run_duplicates(seed);
+    printf("sorted mode with duplicates: %d removals passed\n", DUPLICATE_ITEMS);
+
+    return 0;
+}
+
+void run(unsigned long seed, unsigned long steps, int variant)
+{
+    static Model model;
+
+    memset(&model, 0, sizeof(model));
+    current_model = &model;
+    pool_used = 0;
+    srand(seed * 5 + variant);
+
+    model.owns_data = (variant != 1);
+    model.capacity = (variant == 3) ? 32 : 0;
+    model.list = create_list(&model);
+    if (variant >= 2)
+    {
+        dll_destroy(model.list);
+        model.list = dll_create_deque(copy_item, free_item, model.capacity);
+    }
+    if (variant == 4)
+    {
+        CHECK(dll_set_sorted(model.list, cmp));
+        model.sorted = true;
+    }
+    CHECK(model.list != NULL);
+
+    for (model.step = 0; model.step < steps; ++model.step)
+    {
+        run_step(&model);
+        check_list(&model);
+    }
+
+    dll_destroy(model.list);
+}
+
+/*
+ * Drains a sorted list holding only a few distinct keys in random order
+ * from both ends and the middle. Removals must not compare the removed
+ * node with every node equal to it, which would make draining quadratic.
+ */
+void run_duplicates(unsigned long seed)
+{
+    static Model model;
+
+    memset(&model, 0, sizeof(model));
+    current_model = &model;
+    srand(seed);
+
+    model.op = "dll_insert_sorted (duplicates)";
+    DllList *list = dll_create(copy_item, free_item);
+    CHECK(dll_set_sorted(list, cmp));
+    for (int i = 0; i < DUPLICATE_ITEMS; ++i)
+    {
+        Item item = { .key = rand() % DUPLICATE_KEYS, .seq = next_seq++ };
+        CHECK(dll_insert_sorted(list, &item));
+    }
+
+    unsigned long removal_calls = 0;
+    for (model.step = 0; !dll_is_empty(list); ++model.step)
+    {
+        size_t size = dll_size(list);
+        unsigned long calls = cmp_calls;
+        Item *item = NULL;
+        switch (rand() % 4)
+        {
+        case 0:
+            model.op = "dll_pop_front (duplicates)";
+            item = dll_pop_front(list);
+            break;
+        case 1:
+            model.op = "dll_pop_back (duplicates)";
+            item = dll_pop_back(list);
+            break;
+        case 2:
+            model.op = "dll_extract_at (duplicates)";
+            item = dll_extract_at(list, rand() % size);
+            break;
+        default:
+            model.op = "dll_remove_at (duplicates)";
+            CHECK(dll_remove_at(list, rand() % size));
+            break;
+        }
+        removal_calls += cmp_calls - calls;
+        free(item);
+        CHECK(dll_size(list) == size - 1);
+
+        // The index still finds the first node of every key.
+        if (model.step % 1000 == 0)
+        {
+            model.op = "dll_lower_bound (duplicates)";
+            for (int key = 0; key < DUPLICATE_KEYS; ++key)
+            {
+                Item low = { .key = key };
+                DllNode *node = list->head->next;
+                while ((node != list->tail) && (((Item *) node->data)->key < key))
+                    node = node->next;
+                CHECK(dll_lower_bound(list, &low) == node->data);
+            }
+        }
+    }
+
+    model.op = "sorted mode removals (duplicates)";
+    CHECK(removal_calls <= DUPLICATE_ITEMS);
+    dll_destroy(list);
+}
+
+void run_step(Model *model)
+{
+    DllList *list = model->list;
+    bool full = (model->capacity > 0) && (model->size >= model->capacity);
+    int op = rand() % 29;
+
+    // Keep the list small: once it is large, insertions turn into removals.
+    if ((model->size >= MAX_ITEMS - MERGE_LISTS * 8) && ((op <= 5) || (op == 18) || (op == 19) || (op == 21) || (op == 26)))
+        op = 6 + rand() % 4;
+
+    size_t index = model->size ? (size_t) rand() % (model->size + 1) : 0;
+    Item *item = NULL;
+    Item *source = new_item(model, false);
+    Item key = *source;
+    bool result = false;
+
+    switch (op)
+    {
+    case 0:
+    case 1:
+        model->op = op ? "dll_push_back" : "dll_push_front";
+        result = op ? dll_push_back(list, source) : dll_push_front(list, source);
+        CHECK(result == !full);
+        if (result)
+            model_insert(model, op ? model->size : 0, key);
+        model->sorted = model->sorted && !result;
+        break;
+    case 2:
+    case 3:
+        model->op = (op == 3) ? "dll_push_back_take" : "dll_push_front_take";
+        item = new_item(model, true);
+        result = (op == 3) ? dll_push_back_take(list, item) : dll_push_front_take(list, item);
+        CHECK(result == !full);
+        if (result)
+            model_insert(model, (op == 3) ? model->size : 0, *item);
+        else
+            release(model, item);
+        model->sorted = model->sorted && !result;
+        break;
+    case 4:
+        model->op = "dll_insert_at";
+        result = dll_insert_at(list, index, source);
+        CHECK(result == !full);
+        if (result)
+            model_insert(model, index, key);
+        model->sorted = model->sorted && !result;
+        break;
+    case 5:
+        model->op = "dll_insert_at_take";
+        item = new_item(model, true);
+        result = dll_insert_at_take(list, index, item);
+        CHECK(result == !full);
+        if (result)
+            model_insert(model, index, *item);
+        else
+            release(model, item);
+        model->sorted = model->sorted && !result;
+        break;
+    case 6:
+    case 7:
+        model->op = (op == 6) ? "dll_pop_front" : "dll_pop_back";
+        item = (op == 6) ? dll_pop_front(list) : dll_pop_back(list);
+        CHECK((item != NULL) == (model->size > 0));
+        if (!item)
+            break;
+        index = (op == 6) ? 0 : model->size - 1;
+        CHECK((item->key == model->items[index].key) && (item->seq == model->items[index].seq));
+        model_remove(model, index);
+        release(model, item);
+        break;
+    case 8:
+        model->op = "dll_remove_at";
+        CHECK(dll_remove_at(list, index) == (index < model->size));
+        if (index < model->size)
+            model_remove(model, index);
+        break;
+    case 9:
+        model->op = "dll_extract_at";
+        item = dll_extract_at(list, index);
+        CHECK((item != NULL) == (index < model->size));
+        if (!item)
+            break;
+        CHECK((item->key == model->items[index].key) && (item->seq == model->items[index].seq));
+        model_remove(model, index);
+        release(model, item);
+        break;
+    case 10:
+        model->op = "dll_get_at";
+        item = dll_get_at(list, index);
+        CHECK((item != NULL) == (index < model->size));
+        if (item)
+            CHECK(item->seq == model->items[index].seq);
+        break;
+    case 11:
+        model->op = "dll_sort";
+        dll_sort(list, cmp);
+        model_sort(model->items, model->size);
+        break;
+    case 12:
+        model->op = "dll_bubble_sort";
+        dll_bubble_sort(list, cmp);
+        model_sort(model->items, model->size);
+        model->sorted = model->sorted && (model->size < 2);
+        break;
+    case 13:
+        model->op = "dll_reverse";
+        dll_reverse(list);
+        for (size_t i = 0, j = model->size; i + 1 < j; ++i, --j)
+        {
+            key = model->items[i];
+            model->items[i] = model->items[j - 1];
+            model->items[j - 1] = key;
+        }
+        model->sorted = model->sorted && (model->size < 2);
+        break;
+    case 14:
+    {
+        model->op = "dll_for_each";
+        long long sum = 0;
+        long long expected = 0;
+        dll_for_each(list, sum_item, &sum);
+        for (size_t i = 0; i < model->size; ++i)
+            expected += model->items[i].seq;
+        CHECK(sum == expected);
+        break;
+    }
+    case 15:
+    {
+        model->op = "dll_copy";
+        DllList *copy = dll_copy(list);
+        CHECK(copy != NULL);
+        check_same(copy, model->items, model->size);
+        CHECK((copy->index != NULL) == model->sorted);
+        CHECK(copy->capacity == model->capacity);
+        dll_destroy(copy);
+        break;
+    }
+    case 16:
+        model->op = "dll_clear";
+        dll_clear(list);
+        model->size = 0;
+        CHECK(list->pending == NULL);
+        break;
+    case 17:
+        model->op = "dll_clear_deferred";
+        dll_clear_deferred(list);
+        model->size = 0;
+        dll_reclaim(list, rand() % 8);
+        break;
+    case 18:
+    case 19:
+    {
+        // Both the list and the other lists are sorted first.
+        model->op = (op == 18) ? "dll_merge" : "dll_merge_k";
+        dll_sort(list, cmp);
+        model_sort(model->items, model->size);
+
+        DllList *others[MERGE_LISTS];
+        size_t count = (op == 18) ? 1 : (size_t) rand() % (MERGE_LISTS + 1);
+        size_t total = model->size;
+        for (size_t i = 0; i < count; ++i)
+        {
+            others[i] = create_list(model);
+            for (int j = rand() % 8; j > 0; --j)
+            {
+                item = new_item(model, false);
+                CHECK(dll_push_back(others[i], item));
+                model->items[total++] = *item;
+            }
+            dll_sort(others[i], cmp);
+        }
+
+        if (op == 18)
+            result = dll_merge(list, others[0], cmp);
+        else
+            result = dll_merge_k(list, others, count, cmp);
+        CHECK(result == ((model->capacity == 0) || (total <= model->capacity)));
+
+        // Stable merging keeps equal keys in the order of the lists, and the sorted mode.
+        if (result)
+        {
+            model->size = total;
+            model_sort(model->items, model->size);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            CHECK(!result || dll_is_empty(others[i]));
+            dll_destroy(others[i]);
+        }
+        break;
+    }
+    case 20:
+        model->op = "dll_set_sorted";
+        model->sorted = rand() % 4 != 0;
+        CHECK(dll_set_sorted(list, model->sorted ? cmp : NULL));
+        if (model->sorted)
+            model_sort(model->items, model->size);
+        break;
+    case 21:
+    {
+        model->op = "dll_insert_sorted";
+        result = dll_insert_sorted(list, source);
+        CHECK(result == (model->sorted && !full));
+        if (!result)
+            break;
+        // The new item goes after the equal ones.
+        index = 0;
+        while ((index < model->size) && (model->items[index].key <= key.key))
+            ++index;
+        model_insert(model, index, key);
+        break;
+    }
+    case 22:
+    {
+        model->op = "dll_lower_bound";
+        Item high = { .key = key.key + rand() % 4, .seq = 0 };
+        Item *lower = dll_lower_bound(list, &key);
+        Item *upper = dll_upper_bound(list, &key);
+        size_t count = 0;
+        size_t range = dll_range(list, &key, &high, count_item, &count);
+        if (!model->sorted)
+        {
+            CHECK(!lower && !upper && (range == 0));
+            break;
+        }
+
+        size_t first = 0;
+        while ((first < model->size) && (model->items[first].key < key.key))
+            ++first;
+        size_t last = first;
+        while ((last < model->size) && (model->items[last].key <= key.key))
+            ++last;
+        size_t end = first;
+        while ((end < model->size) && (model->items[end].key < high.key))
+            ++end;
+
+        CHECK(lower == NULL ? first == model->size : lower->seq == model->items[first].seq);
+        CHECK(upper == NULL ? last == model->size : upper->seq == model->items[last].seq);
+        CHECK((range == end - first) && (count == range));
+        break;
+    }
+    case 23:
+        model->op = "dll_relink_by_address";
+        CHECK(dll_relink_by_address(list));
+        break;
+    case 24:
+        model->op = "dll_compact";
+        CHECK(dll_compact(list, (model->owns_data && rand() % 2) ? sizeof(Item) : 0));
+        break;
+    case 25:
+        model->op = "dll_compact (borrowed payloads)";
+        CHECK(dll_compact(list, sizeof(Item)) == model->owns_data);
+        break;
+    case 26:
+    {
+        // Elements of another list are moved to the back of this one.
+        model->op = "dll_splice_front (into the list)";
+        DllList *other = create_list(model);
+        size_t other_size = rand() % 8;
+        for (size_t i = 0; i < other_size; ++i)
+        {
+            item = new_item(model, false);
+            CHECK(dll_push_back(other, item));
+            model->items[model->size + i] = *item;
+        }
+
+        size_t count = rand() % 10;
+        size_t moved = (count < other_size) ? count : other_size;
+        result = dll_splice_front(list, other, count);
+        CHECK(result == ((model->capacity == 0) || (model->size + moved <= model->capacity)));
+        if (result)
+        {
+            model->size += moved;
+            model->sorted = model->sorted && (moved == 0);
+            CHECK(dll_size(other) == other_size - moved);
+        }
+        dll_destroy(other);
+        break;
+    }
+    case 27:
+    {
+        // The first elements of this list are moved to another one.
+        model->op = "dll_splice_front (out of the list)";
+        DllList *other = create_list(model);
+        size_t count = rand() % 10;
+        size_t moved = (count < model->size) ? count : model->size;
+        bool compacted = list->blocks && (moved > 0) && (moved < model->size);
+        CHECK(dll_splice_front(other, list, count) == !compacted);
+        if (!compacted)
+        {
+            check_same(other, model->items, moved);
+            for (size_t i = 0; i < moved; ++i)
+                model_remove(model, 0);
+            model->sorted = model->sorted && (moved == 0);
+        }
+        dll_destroy(other);
+        break;
+    }
+    default:
+        model->op = "dll_size";
+        CHECK(dll_size(list) == model->size);
+        CHECK(dll_is_empty(list) == (model->size == 0));
+        CHECK(dll_is_full(list) == full);
+        break;
+    }
+}
+
+void check_list(const Model *model)
+{
+    const DllList *list = model->list;
+
+    CHECK((list->index != NULL) == model->sorted);
+    CHECK((list->cmp != NULL) == model->sorted);
+    CHECK(dll_size(list) == model->size);
+    CHECK((model->capacity == 0) || (model->size <= model->capacity));
+    check_same(list, model->items, model->size);
+}
+
+void check_same(const DllList *list, const Item *items, size_t size)
+{
+    CHECK(list->size == size);
+
+    // The limiters are never part of the elements.
+    CHECK(list->head->prev == NULL && list->head->data == NULL);
+    CHECK(list->tail->next == NULL && list->tail->data == NULL);
+
+    if (list->ring)
+    {
+        CHECK(list->head->next == list->tail && list->tail->prev == list->head);
+        for (size_t i = 0; i < size; ++i)
+        {
+            const Item *item = dll_get_at(list, i);
+            CHECK(item->seq == items[i].seq && item->key == items[i].key);
+        }
+        return;
+    }
+
+    size_t count = 0;
+    for (const DllNode *node = list->head; node != list->tail; node = node->next)
+    {
+        CHECK(node->next != NULL && node->next->prev == node);
+        if (node == list->head)
+            continue;
+
+        CHECK(count < size);
+        const Item *item = node->data;
+        CHECK(item->seq == items[count].seq && item->key == items[count].key);
+        ++count;
+    }
+    CHECK(count == size);
+}
+
+void model_insert(Model *model, size_t index, Item item)
+{
+    if (index > model->size)
+        index = model->size;
+
+    memmove(&model->items[index + 1], &model->items[index], (model->size - index) * sizeof(Item));
+    model->items[index] = item;
+    ++model->size;
+}
+
+void model_remove(Model *model, size_t index)
+{
+    memmove(&model->items[index], &model->items[index + 1], (model->size - index - 1) * sizeof(Item));
+    --model->size;
+}
+
+void model_sort(Item *items, size_t size)
+{
+    // Insertion sort is stable, like both sorts of the list.
+    Item temp;
+    for (size_t i = 1; i < size; ++i)
+    {
+        temp = items[i];
+        size_t j = i;
+        for (; (j > 0) && (items[j - 1].key > temp.key); --j)
+            items[j] = items[j - 1];
+        items[j] = temp;
+    }
+}
+
+Item next_item(void)
+{
+    Item item = { .key = rand() % MAX_KEY, .seq = next_seq++ };
+    return item;
+}
+
+Item *new_item(Model *model, bool owned)
+{
+    Item *item = NULL;
+
+    if (model->owns_data && owned)
+        item = malloc(sizeof(Item));
+    else
+    {
+        CHECK(pool_used < sizeof(pool) / sizeof(pool[0]));
+        item = &pool[pool_used++];
+    }
+
+    CHECK(item != NULL);
+    *item = next_item();
+    return item;
+}
+
+void release(const Model *model, Item *item)
+{
+    if (model->owns_data)
+        free(item);
+}
+
+DllList *create_list(const Model *model)
+{
+    if (model->owns_data)
+        return dll_create(copy_item, free_item);
+
+    // A list borrowing its data stores the pointers it is given, so they must stay valid.
+    return dll_create(NULL, NULL);
+}
+
+void check(bool condition, const char *text, int line)
+{
+    if (condition)
+        return;
+
+    fprintf(stderr, "step %lu, %s: check failed at line %d: %s\n",
+            current_model->step, current_model->op, line, text);
+    abort();
+}
+
+void *copy_item(const void *item)
+{
+    Item *new_item = malloc(sizeof(Item));
+    if (new_item)
+        *new_item = *((const Item *) item);
+
+    return new_item;
+}
+
+void free_item(void *item)
+{
+    free((Item *) item);
+}
+
+int cmp(const void *item_1, const void *item_2)
+{
+    ++cmp_calls;
+
+    // Any negative or positive value is allowed, not only -1 and 1.
+    return (((const Item *) item_1)->key - ((const Item *) item_2)->key) * 7;
+}
+
+void sum_item(void *data, void *arg)
+{
+    *((long long *) arg) += ((Item *) data)->seq;
+}
+
+void count_item(void *data, void *arg)
+{
+    ++*((size_t *) arg);
+}
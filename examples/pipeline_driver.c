@@ -0,0 +1,130 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <doubly_linked_list.h>
+#include <doubly_linked_list_pipeline.h>
+
+#define ITEMS_COUNT 1000000
+#define CHAIN_SIZE 1000
+
+typedef struct {
+    DllPipeline *pipeline;
+    int items_count;
+    int chain_size;
+} Producer;
+
+void * copy_item(const void *item);
+void free_item(void *item);
+void square_item(void *item, void *arg);
+bool is_even(const void *item, void *arg);
+void print_item(void *item, void *arg);
+void sum_item(void *item, void *arg);
+void *produce(void *arg);
+DllPipeline *create_pipeline(size_t batch_size);
+
+int main(void)
+{
+    // Squares of 1..20, only the even ones, in batches of 4.
+    DllPipeline *pipeline = create_pipeline(4);
+    Producer producer = { pipeline, 20, 3 };
+    pthread_t thread;
+    pthread_create(&thread, NULL, produce, &producer);
+
+    DllList *batch = dll_create(copy_item, free_item);
+    printf("Batches coming out of the pipeline:\n");
+    while (dll_pipeline_pop(pipeline, batch))
+    {
+        dll_for_each(batch, print_item, NULL);
+        putchar('\n');
+        dll_clear(batch);
+    }
+    pthread_join(thread, NULL);
+    dll_pipeline_destroy(pipeline);
+
+    printf("\n****************\n");
+    pipeline = create_pipeline(CHAIN_SIZE);
+    producer = (Producer) { pipeline, ITEMS_COUNT, CHAIN_SIZE };
+    pthread_create(&thread, NULL, produce, &producer);
+
+    long long sum = 0;
+    size_t count = 0;
+    while (dll_pipeline_pop(pipeline, batch))
+    {
+        count += dll_size(batch);
+        dll_for_each(batch, sum_item, &sum);
+        dll_clear(batch);
+    }
+    pthread_join(thread, NULL);
+    dll_pipeline_destroy(pipeline);
+
+    // The squares of the even numbers up to n = 2m sum to 2m(m + 1)(2m + 1) / 3.
+    long long m = ITEMS_COUNT / 2;
+    printf("Streamed %d elements: %zu kept, sum %lld (expected %lld)\n",
+            ITEMS_COUNT, count, sum, 2 * m * (m + 1) * (2 * m + 1) / 3);
+
+    dll_destroy(batch);
+
+    return 0;
+}
+
+DllPipeline *create_pipeline(size_t batch_size)
+{
+    DllPipeline *pipeline = dll_pipeline_create(copy_item, free_item, 8);
+    dll_pipeline_add_map(pipeline, square_item, NULL);
+    dll_pipeline_add_filter(pipeline, is_even, NULL);
+    dll_pipeline_add_batch(pipeline, batch_size);
+    dll_pipeline_start(pipeline);
+
+    return pipeline;
+}
+
+void *produce(void *arg)
+{
+    Producer *producer = arg;
+    DllList *chain = dll_create(copy_item, free_item);
+
+    for (long long i = 1; i <= producer->items_count; ++i)
+    {
+        dll_push_back(chain, &i);
+        if ((dll_size(chain) == (size_t) producer->chain_size) || (i == producer->items_count))
+            dll_pipeline_push(producer->pipeline, chain);
+    }
+    dll_pipeline_close(producer->pipeline);
+    dll_destroy(chain);
+
+    return NULL;
+}
+
+void *copy_item(const void *item)
+{
+    long long *new_item = (long long *) calloc(1, sizeof(long long));
+    *new_item = *((long long *) item);
+
+    return new_item;
+}
+
+void free_item(void *item)
+{
+    free((long long *) item);
+}
+
+void square_item(void *item, void *arg)
+{
+    long long *value = item;
+    *value *= *value;
+}
+
+bool is_even(const void *item, void *arg)
+{
+    return (*((const long long *) item) % 2) == 0;
+}
+
+void print_item(void *item, void *arg)
+{
+    printf("%lld ", *((long long *) item));
+}
+
+void sum_item(void *item, void *arg)
+{
+    *((long long *) arg) += *((long long *) item);
+}
@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <doubly_linked_list.h>
+
+#define ITEMS_COUNT 2000000
+
+void * copy_item(const void *item);
+void free_item(void *item);
+int cmp(const void *item_1, const void *item_2);
+void sum_item(void *data, void *arg);
+double time_for_each(DllList *list);
+
+int main(void)
+{
+    DllList *list = dll_create(copy_item, free_item);
+
+    srand(1);
+    for (int i = 0; i < ITEMS_COUNT; ++i)
+    {
+        int item = rand();
+        dll_push_back(list, &item);
+    }
+    printf("Traversal of %d elements:\n", ITEMS_COUNT);
+    printf("allocation order: %.3fs\n", time_for_each(list));
+
+    // Sorting by random values scatters the list order across the heap.
+    dll_sort(list, cmp);
+    printf("fragmented:       %.3fs\n", time_for_each(list));
+
+    dll_relink_by_address(list);
+    printf("relinked:         %.3fs\n", time_for_each(list));
+
+    dll_compact(list, sizeof(int));
+    printf("compacted:        %.3fs\n", time_for_each(list));
+
+    dll_destroy(list);
+
+    return 0;
+}
+
+void *copy_item(const void *item)
+{
+    int *new_item = (int *) calloc(1, sizeof(int));
+    *new_item = *((int *) item);
+
+    return new_item;
+}
+
+void free_item(void *item)
+{
+    free((int *) item);
+}
+
+int cmp(const void *item_1, const void *item_2)
+{
+    return (*((int *) item_1) > *((int *) item_2)) - (*((int *) item_1) < *((int *) item_2));
+}
+
+void sum_item(void *data, void *arg)
+{
+    *((long long *) arg) += *((int *) data);
+}
+
+double time_for_each(DllList *list)
+{
+    long long sum = 0;
+    clock_t start = clock();
+    dll_for_each(list, sum_item, &sum);
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    if (sum == 0)
+        printf("The list is empty\n");
+    return seconds;
+}
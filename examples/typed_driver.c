@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <doubly_linked_list.h>
+#include <doubly_linked_list_typed.h>
+
+#define ITEMS_COUNT 1000000
+
+static int int_cmp(const int *item_1, const int *item_2)
+{
+    return (*item_1 > *item_2) - (*item_1 < *item_2);
+}
+
+DLL_DEFINE_POD(IntList, int, int_cmp)
+
+void * copy_item(const void *item);
+void free_item(void *item);
+int cmp(const void *item_1, const void *item_2);
+void print_item(int *item, void *arg);
+double seconds_since(clock_t start);
+
+int main(void)
+{
+    IntList *typed_list = IntList_create();
+    DllList *generic_list = dll_create(copy_item, free_item);
+
+    int items[] = { 5, 3, 8, 1, 9, 2 };
+    for (size_t i = 0; i < sizeof(items) / sizeof(items[0]); ++i)
+        IntList_push_back(typed_list, &items[i]);
+    IntList_sort(typed_list);
+    printf("The typed list is sorted:\n");
+    IntList_for_each(typed_list, print_item, NULL);
+    putchar('\n');
+    IntList_clear(typed_list);
+
+    printf("\n****************\n");
+    srand(1);
+    for (int i = 0; i < ITEMS_COUNT; ++i)
+    {
+        int item = rand();
+        IntList_push_back(typed_list, &item);
+        dll_push_back(generic_list, &item);
+    }
+    printf("Benchmark on %d elements (typed / generic):\n", ITEMS_COUNT);
+
+    clock_t start = clock();
+    IntList *typed_copy = IntList_copy(typed_list);
+    double typed_time = seconds_since(start);
+    start = clock();
+    DllList *generic_copy = dll_copy(generic_list);
+    printf("copy:  %.3fs / %.3fs\n", typed_time, seconds_since(start));
+
+    start = clock();
+    IntList_sort(typed_list);
+    typed_time = seconds_since(start);
+    start = clock();
+    dll_sort(generic_list, cmp);
+    printf("sort:  %.3fs / %.3fs\n", typed_time, seconds_since(start));
+
+    start = clock();
+    IntList_destroy(typed_copy);
+    typed_time = seconds_since(start);
+    start = clock();
+    dll_destroy(generic_copy);
+    printf("clear: %.3fs / %.3fs\n", typed_time, seconds_since(start));
+
+    IntList_destroy(typed_list);
+    dll_destroy(generic_list);
+
+    return 0;
+}
+
+void *copy_item(const void *item)
+{
+    int *new_item = (int *) calloc(1, sizeof(int));
+    *new_item = *((int *) item);
+
+    return new_item;
+}
+
+void free_item(void *item)
+{
+    free((int *) item);
+}
+
+int cmp(const void *item_1, const void *item_2)
+{
+    return int_cmp(item_1, item_2);
+}
+
+void print_item(int *item, void *arg)
+{
+    printf("%d ", *item);
+}
+
+double seconds_since(clock_t start)
+{
+    return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
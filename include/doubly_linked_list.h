@@ -13,6 +13,21 @@ typedef struct DllNode {
     struct DllNode *next;   ///< Pointer to the next node.
 } DllNode;
 
+/*
+ * @brief: Skip-list index of a list in sorted mode (opaque).
+ */
+typedef struct DllIndex DllIndex;
+
+/*
+ * @brief: Contiguous blocks of nodes built by 'dll_compact' (opaque).
+ */
+typedef struct DllBlocks DllBlocks;
+
+/*
+ * @brief: Circular array of element pointers of a list in deque mode (opaque).
+ */
+typedef struct DllRing DllRing;
+
 /*
  * @brief: Doubly linked list structure.
  */
@@ -20,6 +35,20 @@ typedef struct {
     DllNode *head;          ///< Pointer to the first node (sentinel head).
     DllNode *tail;          ///< Pointer to the last node (sentinel tail).
     size_t size;            ///< Number of elements in the list.
+    DllNode *pending;       ///< Chain of detached nodes awaiting reclamation (linked through 'next').
+    size_t pending_size;    ///< Number of nodes in the pending chain.
+    DllIndex *index;        ///< Skip-list index over the nodes in sorted mode, NULL otherwise.
+    DllBlocks *blocks;      ///< Blocks of nodes built by 'dll_compact', NULL if there are none.
+    DllRing *ring;          ///< Storage of the elements in deque mode, NULL otherwise.
+    DllRing *pending_rings; ///< Deque storage detached by 'dll_clear_deferred' awaiting reclamation.
+    size_t capacity;        ///< Maximum number of elements, '0' if unlimited.
+
+    /*
+     * @brief: Function the list is ordered by in sorted mode, NULL otherwise.
+     *
+     * @note: Set by 'dll_set_sorted'.
+     */
+    int (*cmp)(const void *item_1, const void *item_2);
     
     /*
      * @brief: Function to copy data.
@@ -48,6 +77,24 @@ typedef struct {
  */
 DllList *dll_create(void *(*copy)(const void *), void (*destroy)(void *));
 
+/*
+ * @brief: Creates a new list in deque mode.
+ *
+ * The elements are kept in a growable circular array instead of separate
+ * nodes, which makes insertions and removals at both ends and 'dll_get_at'
+ * O(1) without a node allocation per element. The list works with the whole
+ * API: the first operation that inserts or removes in the middle, or that
+ * relinks the elements ('dll_sort', 'dll_merge', 'dll_set_sorted', ...),
+ * switches it to linked nodes for good.
+ *
+ * @param copy: Function pointer for copying data.
+ * @param destroy: Function pointer for destroying data.
+ * @param capacity: Maximum number of elements, or '0' for no limit. Insertions
+ * into a full list fail and leave it unchanged.
+ * @return: Pointer to the created list, or NULL on failure.
+ */
+DllList *dll_create_deque(void *(*copy)(const void *), void (*destroy)(void *), size_t capacity);
+
 /*
  * @brief: Destroys the doubly linked list and frees all allocated memory.
  *
@@ -63,6 +110,31 @@ void dll_destroy(DllList *list);
  */
 void dll_clear(DllList *list);
 
+/*
+ * @brief: Clears all elements from the list in constant time, deferring
+ * the release of the nodes and their data.
+ *
+ * The whole chain of nodes is detached from the list and queued for
+ * reclamation; the list is empty and ready for use as soon as the call
+ * returns. The queued nodes are released by 'dll_reclaim' or, at the
+ * latest, by 'dll_clear' and 'dll_destroy'.
+ *
+ * @param list: Pointer to the doubly linked list.
+ */
+void dll_clear_deferred(DllList *list);
+
+/*
+ * @brief: Releases nodes queued by 'dll_clear_deferred'.
+ *
+ * Allows the caller to spread the cost of a large clear over several
+ * steps, e.g. one call per iteration of an event loop.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param budget: Maximum number of nodes to release ('0' releases all of them).
+ * @return: The number of nodes still waiting to be released.
+ */
+size_t dll_reclaim(DllList *list, size_t budget);
+
 /*
  * @brief: Checks if the list is empty.
  *
@@ -71,6 +143,14 @@ void dll_clear(DllList *list);
  */
 bool dll_is_empty(const DllList *list);
 
+/*
+ * @brief: Checks if the list has reached its capacity.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @return true: if no more elements can be inserted, false otherwise.
+ */
+bool dll_is_full(const DllList *list);
+
 /*
  * @brief: Returns the number of elements in the list.
  *
@@ -109,6 +189,45 @@ bool dll_push_back(DllList *list, const void *data);
  */
 bool dll_insert_at(DllList *list, size_t index, const void *data);
 
+/*
+ * @brief: Inserts an already owned element at the front of the list.
+ *
+ * Unlike 'dll_push_front', the data is never passed to the 'copy' function:
+ * the list adopts the pointer and will release it with 'destroy'.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param data: Pointer to the data to adopt.
+ * @return: 'true' on success, 'false' on failure (the caller keeps ownership of the data).
+ */
+bool dll_push_front_take(DllList *list, void *data);
+
+/*
+ * @brief: Inserts an already owned element at the back of the list.
+ *
+ * Unlike 'dll_push_back', the data is never passed to the 'copy' function:
+ * the list adopts the pointer and will release it with 'destroy'.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param data: Pointer to the data to adopt.
+ * @return: 'true' on success, 'false' on failure (the caller keeps ownership of the data).
+ */
+bool dll_push_back_take(DllList *list, void *data);
+
+/*
+ * @brief: Inserts an already owned element at a specified index.
+ *
+ * Unlike 'dll_insert_at', the data is never passed to the 'copy' function:
+ * the list adopts the pointer and will release it with 'destroy'.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param index: Zero-based index where the element should be inserted
+ * (if the index is greater than the size of the list, the element will
+ * be added to the end).
+ * @param data: Pointer to the data to adopt.
+ * @return: 'true' on success, 'false' on failure (the caller keeps ownership of the data).
+ */
+bool dll_insert_at_take(DllList *list, size_t index, void *data);
+
 /*
  * @brief: Removes and returns the element from the front of the list.
  *
@@ -151,6 +270,7 @@ bool dll_remove_at(DllList *list, size_t index);
  * @param list: Pointer to the doubly linked list.
  * @param index: Zero-based index of the node to remove.
  * @return: Pointer to the data of the removed node, or NULL if the index is out of bounds.
+ * @note: The data is not destroyed, the user becomes responsible for freeing it.
  */
 void *dll_extract_at(DllList *list, size_t index);
 
@@ -174,6 +294,68 @@ DllList *dll_copy(const DllList *list);
  */
 void dll_sort(DllList *list, int (*cmp) (const void *, const void *));
 
+/*
+ * @brief: Merges two sorted lists.
+ *
+ * All nodes of 'src' are relinked into 'dst' in linear time without copying
+ * the elements; 'src' is left empty. A list in deque mode is switched to
+ * linked nodes first for good, which allocates a node for each of its
+ * elements, and adopting the blocks of a list compacted by 'dll_compact'
+ * may grow the block table of 'dst'. The merge is stable: equal elements keep
+ * their relative order, and elements of 'dst' precede equal elements of 'src'.
+ * If 'dst' is in sorted mode by 'cmp', it stays in it (its index is rebuilt in O(n)).
+ *
+ * @param dst: Pointer to the sorted list receiving the elements.
+ * @param src: Pointer to the sorted list giving away its elements.
+ * @param cmp: Pointer to the comparison function both lists are sorted by.
+ * @return: 'true' on success, 'false' if the lists are the same, use different
+ * 'copy'/'destroy' functions or 'dst' would exceed its capacity (the lists are
+ * unchanged in these cases), or if an allocation fails (the elements are
+ * unchanged, but a list may already have left deque mode).
+ */
+bool dll_merge(DllList *dst, DllList *src, int (*cmp) (const void *, const void *));
+
+/*
+ * @brief: Moves the first elements of one list to the back of another one.
+ *
+ * The nodes are relinked without copying the elements. Moving all the
+ * elements takes O(1) time, moving a part of them takes O(count) time.
+ * Both lists leave sorted mode. A list in deque mode is switched to linked
+ * nodes first for good, which allocates a node for each of its elements.
+ *
+ * @param dst: Pointer to the list receiving the elements.
+ * @param src: Pointer to the list giving away its elements.
+ * @param count: Number of elements to move (all of them if it exceeds the size of 'src').
+ * @return: 'true' on success, 'false' if the lists are the same, use different
+ * 'copy'/'destroy' functions, 'dst' would exceed its capacity, or only a part of
+ * a list compacted by 'dll_compact' is moved (the lists are unchanged in these
+ * cases), or if an allocation fails (the elements are unchanged, but a list may
+ * already have left deque mode).
+ */
+bool dll_splice_front(DllList *dst, DllList *src, size_t count);
+
+/*
+ * @brief: Merges k sorted lists into a sorted list.
+ *
+ * Runs in O(n log k) time without copying the elements; all 'lists' are left
+ * empty. Lists in deque mode are switched to linked nodes first for good, which
+ * allocates a node for each of their elements, and adopting the blocks of lists
+ * compacted by 'dll_compact' may grow the block table of 'dst'.
+ * The merge is stable: equal elements keep their relative order, elements of
+ * 'dst' go first, then those of 'lists[0]', 'lists[1]', and so on. If 'dst'
+ * is in sorted mode by 'cmp', it stays in it (its index is rebuilt in O(n)).
+ *
+ * @param dst: Pointer to the sorted list receiving the elements.
+ * @param lists: Array of pointers to distinct sorted lists.
+ * @param k: Number of lists in the array.
+ * @param cmp: Pointer to the comparison function all lists are sorted by.
+ * @return: 'true' on success, 'false' if any list is NULL, is 'dst', uses
+ * different 'copy'/'destroy' functions, or 'dst' would exceed its capacity
+ * (no list is modified in these cases), or if an allocation fails (the
+ * elements are unchanged, but some lists may already have left deque mode).
+ */
+bool dll_merge_k(DllList *dst, DllList **lists, size_t k, int (*cmp) (const void *, const void *));
+
 /*
  * @brief: Sorts the list using bubble sort (simpler but less efficient for large lists).
  *
@@ -203,4 +385,96 @@ void dll_for_each(DllList *list, void (*func) (void *, void *), void *arg);
  */
 void dll_reverse(DllList *list);
 
+/*
+ * @brief: Turns the sorted mode of the list on or off.
+ *
+ * In sorted mode the list is kept ordered by 'cmp' and indexed by a skip
+ * list, so that 'dll_insert_sorted', 'dll_lower_bound', 'dll_upper_bound'
+ * and 'dll_range' find their position in O(log n) expected time. Removals
+ * keep the sorted mode, and so do 'dll_sort', 'dll_merge' and 'dll_merge_k'
+ * into the list with its own function. Any other operation that adds or
+ * reorders elements ('dll_push_*', 'dll_insert_at*', 'dll_reverse',
+ * 'dll_bubble_sort', 'dll_splice_front', 'dll_sort', 'dll_merge' and
+ * 'dll_merge_k' with another function) turns it off.
+ *
+ * @param list: Pointer to the doubly linked list (it is sorted if necessary).
+ * @param cmp: Pointer to the comparison function, or NULL to turn the sorted mode off.
+ * @return: 'true' on success, 'false' on failure.
+ * @note: 'dll_for_each' callbacks must not change the ordering keys of a sorted list.
+ */
+bool dll_set_sorted(DllList *list, int (*cmp) (const void *, const void *));
+
+/*
+ * @brief: Inserts an element into a list in sorted mode at its place in the order.
+ *
+ * Equal elements keep their insertion order: the new element goes after them.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param data: Pointer to the data to insert.
+ * @return: 'true' on success, 'false' on failure or if the list is not in sorted mode.
+ */
+bool dll_insert_sorted(DllList *list, const void *data);
+
+/*
+ * @brief: Finds the first element that is not less than the key.
+ *
+ * @param list: Pointer to the doubly linked list in sorted mode.
+ * @param key: Pointer to the key, compared with the list's 'cmp'.
+ * @return: Pointer to the data of the element, or NULL if there is none.
+ */
+void *dll_lower_bound(const DllList *list, const void *key);
+
+/*
+ * @brief: Finds the first element that is greater than the key.
+ *
+ * @param list: Pointer to the doubly linked list in sorted mode.
+ * @param key: Pointer to the key, compared with the list's 'cmp'.
+ * @return: Pointer to the data of the element, or NULL if there is none.
+ */
+void *dll_upper_bound(const DllList *list, const void *key);
+
+/*
+ * @brief: Applies a function to each element in the range [low, high).
+ *
+ * @param list: Pointer to the doubly linked list in sorted mode.
+ * @param low: Pointer to the inclusive lower key.
+ * @param high: Pointer to the exclusive upper key.
+ * @param func: Function to apply to each element.
+ * @param arg: Additional user-defined data passed to the function.
+ * @return: The number of elements in the range.
+ */
+size_t dll_range(DllList *list, const void *low, const void *high,
+        void (*func) (void *, void *), void *arg);
+
+/*
+ * @brief: Relinks the nodes of the list in the order of their addresses.
+ *
+ * The elements keep their order, but are moved between the existing nodes
+ * so that a traversal walks memory forward instead of jumping across the
+ * heap. Pointers to the data remain valid, pointers to the nodes do not.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @return: 'true' on success, 'false' on failure (the list is unchanged).
+ */
+bool dll_relink_by_address(DllList *list);
+
+/*
+ * @brief: Rebuilds the list in one contiguous block of memory.
+ *
+ * All nodes are moved into a single allocation in list order, so that a
+ * traversal reads memory sequentially. The list itself and the order of
+ * its elements do not change. Nodes released later are reused for new
+ * elements, and the block is freed once none of its memory is in use.
+ *
+ * @param list: Pointer to the doubly linked list.
+ * @param data_size: If not '0', the payloads are also moved into the block
+ * right after the nodes. This requires a list that owns its data (created
+ * with 'copy' and 'destroy') and flat payloads of exactly 'data_size' bytes,
+ * since the old payloads are released with 'destroy' after being copied
+ * byte by byte. Popped or extracted payloads are handed over as copies.
+ * @return: 'true' on success, 'false' on failure (the list is unchanged).
+ * @note: Pointers to the nodes, and to the payloads if they are moved, become invalid.
+ */
+bool dll_compact(DllList *list, size_t data_size);
+
 #endif // DOUBLY_LINKED_LIST_H
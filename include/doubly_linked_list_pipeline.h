@@ -0,0 +1,132 @@
+#ifndef DOUBLY_LINKED_LIST_PIPELINE_H
+#define DOUBLY_LINKED_LIST_PIPELINE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <doubly_linked_list.h>
+
+/*
+ * @brief: Streaming pipeline of list stages (opaque).
+ *
+ * Elements flow through a chain of map, filter and batch stages in chains
+ * of nodes. Every stage runs on its own thread, and consecutive stages are
+ * connected by bounded queues of chains. Chains are handed over with
+ * 'dll_splice_front', so the elements are never copied between stages.
+ *
+ * Typical use:
+ *     DllPipeline *pipeline = dll_pipeline_create(copy, destroy, 8);
+ *     dll_pipeline_add_map(pipeline, square, NULL);
+ *     dll_pipeline_add_filter(pipeline, is_even, NULL);
+ *     dll_pipeline_start(pipeline);
+ *
+ *     // Producer thread:          // Consumer thread:
+ *     dll_pipeline_push(p, list);  while (dll_pipeline_pop(p, out))
+ *     dll_pipeline_close(p);           ...
+ *
+ *     dll_pipeline_destroy(pipeline);
+ */
+typedef struct DllPipeline DllPipeline;
+
+/*
+ * @brief: Creates a new pipeline without stages.
+ *
+ * @param copy: Function pointer for copying data (the one of the lists passed in and out).
+ * @param destroy: Function pointer for destroying data (the one of the lists passed in and out).
+ * @param queue_capacity: Number of chains each queue holds before its producer blocks.
+ * @return: Pointer to the created pipeline, or NULL on failure.
+ */
+DllPipeline *dll_pipeline_create(void *(*copy)(const void *), void (*destroy)(void *),
+        size_t queue_capacity);
+
+/*
+ * @brief: Appends a stage applying a function to every element in place.
+ *
+ * @param pipeline: Pointer to the pipeline, not started yet.
+ * @param func: Function to apply to each element.
+ * @param arg: Additional user-defined data passed to the function.
+ * @return: 'true' on success, 'false' on failure.
+ * @note: The function runs on the thread of the stage.
+ */
+bool dll_pipeline_add_map(DllPipeline *pipeline, void (*func) (void *, void *), void *arg);
+
+/*
+ * @brief: Appends a stage keeping only the elements accepted by a predicate.
+ *
+ * Rejected elements are removed (and destroyed if the pipeline owns its data).
+ *
+ * @param pipeline: Pointer to the pipeline, not started yet.
+ * @param keep: Predicate returning 'true' for the elements to pass on.
+ * @param arg: Additional user-defined data passed to the predicate.
+ * @return: 'true' on success, 'false' on failure.
+ * @note: The predicate runs on the thread of the stage.
+ */
+bool dll_pipeline_add_filter(DllPipeline *pipeline, bool (*keep) (const void *, void *), void *arg);
+
+/*
+ * @brief: Appends a stage regrouping the elements into chains of a fixed size.
+ *
+ * The last chain may be shorter, it is passed on when the input is closed.
+ *
+ * @param pipeline: Pointer to the pipeline, not started yet.
+ * @param batch_size: Number of elements per chain.
+ * @return: 'true' on success, 'false' on failure.
+ */
+bool dll_pipeline_add_batch(DllPipeline *pipeline, size_t batch_size);
+
+/*
+ * @brief: Starts one thread per stage.
+ *
+ * @param pipeline: Pointer to the pipeline.
+ * @return: 'true' on success, 'false' on failure or if it is already started.
+ */
+bool dll_pipeline_start(DllPipeline *pipeline);
+
+/*
+ * @brief: Feeds all the elements of a list into the pipeline as one chain.
+ *
+ * The nodes are moved in O(1) time and 'items' is left empty. Blocks while
+ * the input queue is full.
+ *
+ * @param pipeline: Pointer to the started pipeline.
+ * @param items: Pointer to a list with the same 'copy'/'destroy' functions as the pipeline.
+ * @return: 'true' on success, 'false' on failure or if the input is closed.
+ * Lists in deque mode are refused, since they would have to be converted to
+ * linked nodes, and so are lists compacted by 'dll_compact', since stages
+ * split chains.
+ */
+bool dll_pipeline_push(DllPipeline *pipeline, DllList *items);
+
+/*
+ * @brief: Signals the end of the input.
+ *
+ * The stages drain the elements already pushed and then finish one after another.
+ *
+ * @param pipeline: Pointer to the started pipeline.
+ * @return: 'true' on success, 'false' on failure.
+ */
+bool dll_pipeline_close(DllPipeline *pipeline);
+
+/*
+ * @brief: Takes the next chain coming out of the last stage.
+ *
+ * The nodes are moved to the back of 'out' in O(1) time. Blocks until a
+ * chain is available or the pipeline is finished.
+ *
+ * @param pipeline: Pointer to the started pipeline.
+ * @param out: Pointer to a list with the same 'copy'/'destroy' functions as the
+ * pipeline, neither in deque mode nor limited by a capacity (the call fails
+ * right away otherwise, so that 'false' never hides elements still queued).
+ * @return: 'true' if a chain was moved, 'false' once the pipeline is closed
+ * and drained, or if 'out' is refused.
+ */
+bool dll_pipeline_pop(DllPipeline *pipeline, DllList *out);
+
+/*
+ * @brief: Stops the stages and frees the pipeline with the elements still in it.
+ *
+ * @param pipeline: Pointer to the pipeline.
+ * @note: Must not be called while other threads push or pop.
+ */
+void dll_pipeline_destroy(DllPipeline *pipeline);
+
+#endif // DOUBLY_LINKED_LIST_PIPELINE_H
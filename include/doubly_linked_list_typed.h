@@ -0,0 +1,333 @@
+#ifndef DOUBLY_LINKED_LIST_TYPED_H
+#define DOUBLY_LINKED_LIST_TYPED_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*
+ * @brief: Type-specialized doubly linked lists.
+ *
+ * 'DLL_DEFINE(name, T, cmp, copy, destroy)' generates a list type 'name'
+ * whose nodes store elements of type 'T' inline, together with a set of
+ * 'static inline' functions mirroring the generic 'dll_*' API
+ * ('name_create', 'name_push_back', 'name_sort', ...).
+ *
+ * The callbacks are bound at compile time, so the compiler is free to
+ * inline them into the sorting, copying and clearing loops:
+ * - int cmp(const T *a, const T *b): follows the convention of 'qsort'.
+ * - bool copy(T *dst, const T *src): copies an element, returns 'false' on failure.
+ * - void destroy(T *item): releases the resources owned by an element.
+ *
+ * 'DLL_DEFINE_POD(name, T, cmp)' defines a list of plain values that are
+ * copied by assignment and need no destruction.
+ *
+ * Example:
+ *     static int int_cmp(const int *a, const int *b) { return (*a > *b) - (*a < *b); }
+ *     DLL_DEFINE_POD(IntList, int, int_cmp)
+ *
+ *     IntList *list = IntList_create();
+ *     IntList_push_back(list, &(int){ 42 });
+ */
+
+#define DLL_DEFINE_POD(name, T, cmp)                                            \
+    static inline bool name##_pod_copy(T *dst, const T *src)                    \
+    {                                                                           \
+        *dst = *src;                                                            \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline void name##_pod_destroy(T *item)                              \
+    {                                                                           \
+        (void) item;                                                            \
+    }                                                                           \
+                                                                                \
+    DLL_DEFINE(name, T, cmp, name##_pod_copy, name##_pod_destroy)
+
+#define DLL_DEFINE(name, T, cmp, copy, destroy)                                 \
+    typedef struct name##_node {                                                \
+        T data;                     /* Element stored in the node. */           \
+        struct name##_node *prev;   /* Pointer to the previous node. */         \
+        struct name##_node *next;   /* Pointer to the next node. */             \
+    } name##_node;                                                              \
+                                                                                \
+    typedef struct {                                                            \
+        name##_node head;           /* Sentinel head. */                        \
+        name##_node tail;           /* Sentinel tail. */                        \
+        size_t size;                /* Number of elements in the list. */       \
+    } name;                                                                     \
+                                                                                \
+    static inline name *name##_create(void)                                     \
+    {                                                                           \
+        name *list = calloc(1, sizeof(name));                                   \
+        if (!list)                                                              \
+            return NULL;                                                        \
+                                                                                \
+        list->head.next = &list->tail;                                          \
+        list->tail.prev = &list->head;                                          \
+        return list;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline void name##_clear(name *list)                                 \
+    {                                                                           \
+        if (!list || (list->size == 0))                                         \
+            return;                                                             \
+                                                                                \
+        name##_node *cur_node = list->head.next;                                \
+        name##_node *temp_node = NULL;                                          \
+        while (cur_node != &list->tail)                                         \
+        {                                                                       \
+            temp_node = cur_node;                                               \
+            cur_node = cur_node->next;                                          \
+            destroy(&temp_node->data);                                          \
+            free(temp_node);                                                    \
+        }                                                                       \
+                                                                                \
+        list->head.next = &list->tail;                                          \
+        list->tail.prev = &list->head;                                          \
+        list->size = 0;                                                         \
+    }                                                                           \
+                                                                                \
+    static inline void name##_destroy(name *list)                               \
+    {                                                                           \
+        if (!list)                                                              \
+            return;                                                             \
+                                                                                \
+        name##_clear(list);                                                     \
+        free(list);                                                             \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_is_empty(const name *list)                        \
+    {                                                                           \
+        return !list || (list->size == 0);                                      \
+    }                                                                           \
+                                                                                \
+    static inline size_t name##_size(const name *list)                          \
+    {                                                                           \
+        return list ? list->size : 0;                                           \
+    }                                                                           \
+                                                                                \
+    static inline name##_node *name##_get_node_at(const name *list,             \
+            size_t index)                                                       \
+    {                                                                           \
+        name##_node *node = NULL;                                               \
+        if (index <= (list->size / 2))                                          \
+        {                                                                       \
+            node = list->head.next;                                             \
+            for (size_t i = 0; i < index; ++i)                                  \
+                node = node->next;                                              \
+        }                                                                       \
+        else                                                                    \
+        {                                                                       \
+            node = (name##_node *) &list->tail;                                 \
+            for (size_t i = list->size; i > index; --i)                         \
+                node = node->prev;                                              \
+        }                                                                       \
+        return node;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_link_copy(name *list, name##_node *before,        \
+            const T *item)                                                      \
+    {                                                                           \
+        name##_node *new_node = calloc(1, sizeof(name##_node));                 \
+        if (!new_node)                                                          \
+            return false;                                                       \
+        if (!copy(&new_node->data, item))                                       \
+        {                                                                       \
+            free(new_node);                                                     \
+            return false;                                                       \
+        }                                                                       \
+                                                                                \
+        new_node->prev = before->prev;                                          \
+        new_node->next = before;                                                \
+        before->prev->next = new_node;                                          \
+        before->prev = new_node;                                                \
+        ++list->size;                                                           \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_push_front(name *list, const T *item)             \
+    {                                                                           \
+        if (!list)                                                              \
+            return false;                                                       \
+        return name##_link_copy(list, list->head.next, item);                   \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_push_back(name *list, const T *item)              \
+    {                                                                           \
+        if (!list)                                                              \
+            return false;                                                       \
+        return name##_link_copy(list, &list->tail, item);                       \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_insert_at(name *list, size_t index,               \
+            const T *item)                                                      \
+    {                                                                           \
+        if (!list)                                                              \
+            return false;                                                       \
+        if (index > list->size)                                                 \
+            index = list->size;                                                 \
+        return name##_link_copy(list, name##_get_node_at(list, index), item);   \
+    }                                                                           \
+                                                                                \
+    /* Unlinks a node; moves its element to 'out' or destroys it. */           \
+    static inline void name##_release_node(name *list, name##_node *node,       \
+            T *out)                                                             \
+    {                                                                           \
+        node->prev->next = node->next;                                          \
+        node->next->prev = node->prev;                                          \
+        --list->size;                                                           \
+                                                                                \
+        if (out)                                                                \
+            *out = node->data;                                                  \
+        else                                                                    \
+            destroy(&node->data);                                               \
+        free(node);                                                             \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_pop_front(name *list, T *out)                     \
+    {                                                                           \
+        if (!list || (list->size == 0))                                         \
+            return false;                                                       \
+        name##_release_node(list, list->head.next, out);                        \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_pop_back(name *list, T *out)                      \
+    {                                                                           \
+        if (!list || (list->size == 0))                                         \
+            return false;                                                       \
+        name##_release_node(list, list->tail.prev, out);                        \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline bool name##_remove_at(name *list, size_t index)               \
+    {                                                                           \
+        if (!list || (list->size <= index))                                     \
+            return false;                                                       \
+        name##_release_node(list, name##_get_node_at(list, index), NULL);       \
+        return true;                                                            \
+    }                                                                           \
+                                                                                \
+    static inline T *name##_get_at(const name *list, size_t index)              \
+    {                                                                           \
+        if (!list || (list->size <= index))                                     \
+            return NULL;                                                        \
+        return &name##_get_node_at(list, index)->data;                          \
+    }                                                                           \
+                                                                                \
+    static inline void name##_for_each(name *list,                              \
+            void (*func) (T *, void *), void *arg)                              \
+    {                                                                           \
+        for (name##_node *node = list->head.next; node != &list->tail;          \
+                node = node->next)                                              \
+            func(&node->data, arg);                                             \
+    }                                                                           \
+                                                                                \
+    static inline name *name##_copy(const name *list)                           \
+    {                                                                           \
+        if (!list)                                                              \
+            return NULL;                                                        \
+                                                                                \
+        name *new_list = name##_create();                                       \
+        if (!new_list)                                                          \
+            return NULL;                                                        \
+                                                                                \
+        for (name##_node *node = list->head.next; node != &list->tail;          \
+                node = node->next)                                              \
+        {                                                                       \
+            if (!name##_link_copy(new_list, &new_list->tail, &node->data))      \
+            {                                                                   \
+                name##_destroy(new_list);                                       \
+                return NULL;                                                    \
+            }                                                                   \
+        }                                                                       \
+        return new_list;                                                        \
+    }                                                                           \
+                                                                                \
+    static inline void name##_reverse(name *list)                               \
+    {                                                                           \
+        if (!list || (list->size < 2))                                          \
+            return;                                                             \
+                                                                                \
+        name##_node *node = &list->head;                                        \
+        name##_node *temp = NULL;                                               \
+        while (node)                                                            \
+        {                                                                       \
+            temp = node->next;                                                  \
+            node->next = node->prev;                                            \
+            node->prev = temp;                                                  \
+            node = temp;                                                        \
+        }                                                                       \
+                                                                                \
+        /* The sentinels have swapped roles, swap them back. */                 \
+        temp = list->head.prev;                                                 \
+        list->head.prev = NULL;                                                 \
+        list->head.next = list->tail.next;                                      \
+        list->tail.next = NULL;                                                 \
+        list->tail.prev = temp;                                                 \
+        list->head.next->prev = &list->head;                                    \
+        list->tail.prev->next = &list->tail;                                    \
+    }                                                                           \
+                                                                                \
+    /* Sorts a NULL terminated chain of 'size' nodes linked by 'next'. */      \
+    static inline name##_node *name##_merge_sort(name##_node *start,            \
+            size_t size)                                                        \
+    {                                                                           \
+        if (size < 2)                                                           \
+            return start;                                                       \
+                                                                                \
+        size_t left_part_size = size / 2;                                       \
+        name##_node *left_part_end = start;                                     \
+        for (size_t i = 1; i < left_part_size; ++i)                             \
+            left_part_end = left_part_end->next;                                \
+        name##_node *right_part = left_part_end->next;                          \
+        left_part_end->next = NULL;                                             \
+                                                                                \
+        name##_node *left_part = name##_merge_sort(start, left_part_size);      \
+        right_part = name##_merge_sort(right_part, size - left_part_size);      \
+                                                                                \
+        /* Equal elements keep their order: the left part wins ties. */         \
+        name##_node unity = { .next = NULL };                                   \
+        name##_node *unity_end = &unity;                                        \
+        while (left_part && right_part)                                         \
+        {                                                                       \
+            if (cmp(&right_part->data, &left_part->data) < 0)                   \
+            {                                                                   \
+                unity_end->next = right_part;                                   \
+                right_part = right_part->next;                                  \
+            }                                                                   \
+            else                                                                \
+            {                                                                   \
+                unity_end->next = left_part;                                    \
+                left_part = left_part->next;                                    \
+            }                                                                   \
+            unity_end = unity_end->next;                                        \
+        }                                                                       \
+        unity_end->next = left_part ? left_part : right_part;                   \
+                                                                                \
+        return unity.next;                                                      \
+    }                                                                           \
+                                                                                \
+    static inline void name##_sort(name *list)                                  \
+    {                                                                           \
+        if (!list || (list->size < 2))                                          \
+            return;                                                             \
+                                                                                \
+        list->tail.prev->next = NULL;                                           \
+        name##_node *node = name##_merge_sort(list->head.next, list->size);     \
+                                                                                \
+        /* Restore the backward links. */                                       \
+        name##_node *prev = &list->head;                                        \
+        prev->next = node;                                                      \
+        while (node)                                                            \
+        {                                                                       \
+            node->prev = prev;                                                  \
+            prev = node;                                                        \
+            node = node->next;                                                  \
+        }                                                                       \
+        prev->next = &list->tail;                                               \
+        list->tail.prev = prev;                                                 \
+    }
+
+#endif // DOUBLY_LINKED_LIST_TYPED_H
@@ -1,6 +1,8 @@
 #include <stdlib.h>
 #include <doubly_linked_list.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 
 DllList *dll_create(void * (*copy) (const void *data),
         void (*destroy) (void *data))
@@ -29,6 +31,14 @@ DllList *dll_create(void * (*copy) (const void *data),
     end_limiter->data = NULL;
 
     list->size = 0;
+    list->pending = NULL;
+    list->pending_size = 0;
+    list->index = NULL;
+    list->cmp = NULL;
+    list->blocks = NULL;
+    list->ring = NULL;
+    list->pending_rings = NULL;
+    list->capacity = 0;
     list->copy = copy;
     list->destroy = destroy;
     list->head = top_limiter;
@@ -43,502 +53,2008 @@ DllList *dll_create(void * (*copy) (const void *data),
     return NULL;
 }
 
+/*
+ * @brief: Contiguous block of nodes (and optionally payloads) built by 'dll_compact'.
+ *
+ * Nodes and payloads inside a block are never passed to 'free' or 'destroy'
+ * one by one: the block counts those still in use and is freed as a whole
+ * once the count drops to zero.
+ */
+typedef struct DllBlock {
+    DllNode *free_nodes;    ///< Released nodes of the block ready for reuse (linked through 'next').
+    size_t live;            ///< Number of nodes and payloads of the block still in use.
+    uintptr_t end;          ///< Address just past the memory of the block.
+    DllNode nodes[];        ///< The nodes, followed by the payloads.
+} DllBlock;
+
+/*
+ * @brief: Blocks of a list, kept in address order so that they can be binary searched.
+ *
+ * The table exists only while it holds at least one block.
+ */
+struct DllBlocks {
+    size_t count;           ///< Number of blocks.
+    size_t capacity;        ///< Number of slots in 'items'.
+    DllBlock *recent;       ///< Block of the last released node, reused first by 'alloc_node'.
+    DllBlock *items[];      ///< The blocks, sorted by address.
+};
+
+/*
+ * @brief: Finds the position of the first block of the list starting after an address.
+ */
+static size_t block_upper_bound(const DllBlocks *blocks, uintptr_t address)
+{
+    size_t low = 0;
+    size_t high = blocks->count;
+
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if ((uintptr_t) blocks->items[middle] <= address)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+/*
+ * @brief: Finds the block of the list that a node or a payload lives in.
+ *
+ * @param list: Pointer to the list.
+ * @param address: Address of the node or the payload.
+ * @return: Pointer to the block, or NULL if the memory was allocated on its own.
+ * @note: Takes O(log k) time for a list holding k blocks.
+ */
+static DllBlock *find_block(const DllList *list, const void *address)
+{
+    if (!list->blocks)
+        return NULL;
+
+    uintptr_t target = (uintptr_t) address;
+    size_t position = block_upper_bound(list->blocks, target);
+    if (position == 0)
+        return NULL;
+
+    // Blocks do not overlap, so only the last one starting before the address can hold it.
+    DllBlock *block = list->blocks->items[position - 1];
+    if ((target >= (uintptr_t) block->nodes) && (target < block->end))
+        return block;
+
+    return NULL;
+}
+
+/*
+ * @brief: Makes room in the table of a list for more blocks.
+ *
+ * @param list: Pointer to the list.
+ * @param count: Number of blocks about to be added.
+ * @return: 'true' on success, 'false' on failure (the list is unchanged).
+ */
+static bool reserve_blocks(DllList *list, size_t count)
+{
+    size_t used = list->blocks ? list->blocks->count : 0;
+    size_t capacity = list->blocks ? list->blocks->capacity : 0;
+    if ((count == 0) || (used + count <= capacity))
+        return true;
+
+    capacity = (2 * capacity > used + count) ? 2 * capacity : used + count;
+    DllBlocks *blocks = realloc(list->blocks, sizeof(DllBlocks) + capacity * sizeof(DllBlock *));
+    if (!blocks)
+        return false;
+
+    if (!list->blocks)
+    {
+        blocks->count = 0;
+        blocks->recent = NULL;
+    }
+    blocks->capacity = capacity;
+    list->blocks = blocks;
+    return true;
+}
+
+/*
+ * @brief: Adds a new block to the table of a list, which must have room for it.
+ */
+static void insert_block(DllList *list, DllBlock *block)
+{
+    DllBlocks *blocks = list->blocks;
+    size_t position = block_upper_bound(blocks, (uintptr_t) block);
+
+    memmove(&blocks->items[position + 1], &blocks->items[position],
+            (blocks->count - position) * sizeof(DllBlock *));
+    blocks->items[position] = block;
+    ++blocks->count;
+}
+
+/*
+ * @brief: Marks a node or a payload of a block as no longer used, freeing the block with the last one.
+ */
+static void block_release(DllList *list, DllBlock *block)
+{
+    if (--block->live > 0)
+        return;
+
+    DllBlocks *blocks = list->blocks;
+    size_t position = block_upper_bound(blocks, (uintptr_t) block) - 1;
+    memmove(&blocks->items[position], &blocks->items[position + 1],
+            (blocks->count - position - 1) * sizeof(DllBlock *));
+    if (blocks->recent == block)
+        blocks->recent = NULL;
+    free(block);
+
+    if (--blocks->count == 0)
+    {
+        free(blocks);
+        list->blocks = NULL;
+    }
+}
+
+/*
+ * @brief: Allocates a node, reusing a released node of a block if there is one.
+ *
+ * @param list: Pointer to the list.
+ * @return: Pointer to the zeroed node, or NULL on failure.
+ */
+static DllNode *alloc_node(const DllList *list)
+{
+    DllBlock *block = list->blocks ? list->blocks->recent : NULL;
+
+    if (!block || !block->free_nodes)
+        return calloc(1, sizeof(DllNode));
+
+    DllNode *node = block->free_nodes;
+    block->free_nodes = node->next;
+    ++block->live;
+
+    node->data = NULL;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+/*
+ * @brief: Frees a node allocated by 'alloc_node' or 'dll_compact'.
+ */
+static void free_node(DllList *list, DllNode *node)
+{
+    DllBlock *block = find_block(list, node);
+    if (!block)
+    {
+        free(node);
+        return;
+    }
+
+    node->next = block->free_nodes;
+    block->free_nodes = node;
+    list->blocks->recent = block;
+    block_release(list, block);
+}
+
+/*
+ * @brief: Destroys data owned by the list.
+ */
+static void drop_data(DllList *list, void *data)
+{
+    if (!list->destroy)
+        return;
+
+    DllBlock *block = find_block(list, data);
+    if (block)
+        block_release(list, block);
+    else
+        list->destroy(data);
+}
+
+/*
+ * @brief: Makes sure the data of a node can be handed over to the user.
+ *
+ * A payload relocated into a block cannot be freed by the user, so it is
+ * replaced by a copy made with the list's 'copy' function.
+ *
+ * @param list: Pointer to the list.
+ * @param node: Pointer to the node whose data is about to be handed over.
+ * @return: 'true' on success, 'false' on failure (the node is unchanged).
+ */
+static bool own_data(DllList *list, DllNode *node)
+{
+    if (!list->destroy)
+        return true;
+
+    DllBlock *block = find_block(list, node->data);
+    if (!block)
+        return true;
+
+    void *data = list->copy(node->data);
+    if (!data)
+        return false;
+
+    node->data = data;
+    block_release(list, block);
+    return true;
+}
+
+/*
+ * @brief: Counts the blocks a list hands over together with its nodes.
+ *
+ * The pending nodes of the list may live in its blocks, so they are
+ * released first: they must not be freed by the list adopting the blocks.
+ */
+static size_t blocks_to_adopt(DllList *list)
+{
+    if (!list->blocks)
+        return 0;
+
+    dll_reclaim(list, 0);
+    return list->blocks ? list->blocks->count : 0;
+}
+
+/*
+ * @brief: Hands the blocks of one list over to another one.
+ *
+ * Must precede moving nodes from 'src' to 'dst', so that 'dst' can release
+ * them, and follow 'blocks_to_adopt' and 'reserve_blocks' on 'dst' for them.
+ */
+static void adopt_blocks(DllList *dst, DllList *src)
+{
+    if (!src->blocks)
+        return;
+
+    // Both tables are sorted, merge them from the back into the room reserved in 'dst'.
+    DllBlocks *to = dst->blocks;
+    DllBlocks *from = src->blocks;
+    size_t i = to->count;
+    size_t j = from->count;
+    size_t k = i + j;
+    while (j > 0)
+    {
+        if ((i > 0) && ((uintptr_t) to->items[i - 1] > (uintptr_t) from->items[j - 1]))
+            to->items[--k] = to->items[--i];
+        else
+            to->items[--k] = from->items[--j];
+    }
+    to->count += from->count;
+
+    free(from);
+    src->blocks = NULL;
+}
+
+/* Maximum number of express lanes of the skip-list index. */
+#define DLL_INDEX_MAX_LEVEL 16
+
+/*
+ * @brief: Tower of the skip-list index built over a node of a sorted list.
+ *
+ * The nodes of the list itself form the lowest lane of the skip list, so
+ * only about a quarter of them get a tower with one or more express lanes.
+ */
+typedef struct DllIndexEntry {
+    DllNode *node;                  ///< The node this tower belongs to.
+    size_t height;                  ///< Number of express lanes of the tower.
+    struct DllIndexEntry **prev;    ///< The previous tower on each lane, NULL for the head of the index.
+    struct DllIndexEntry *next[];   ///< The next tower on each lane, followed by the 'prev' links.
+} DllIndexEntry;
+
+/*
+ * @brief: Skip-list index of a list in sorted mode.
+ *
+ * Besides the lanes, the index maps the nodes to their towers, so that
+ * removing a node does not have to search its tower among the towers of
+ * all the nodes equal to it.
+ */
+struct DllIndex {
+    size_t level;                   ///< Number of lanes in use.
+    uint32_t seed;                  ///< State of the tower height generator.
+    DllIndexEntry *pending;         ///< Towers of deferred cleared nodes (linked through 'next[0]').
+    DllIndexEntry *next[DLL_INDEX_MAX_LEVEL]; ///< The first tower on each lane.
+    DllIndexEntry **towers;         ///< Open addressing table of the towers by node address.
+    size_t towers_slots;            ///< Number of slots of the table (a power of two, or '0').
+    size_t towers_count;            ///< Number of towers in the table.
+};
+
+/*
+ * @brief: Returns the link to the tower following 'entry' on a lane.
+ *
+ * @param index: Pointer to the index.
+ * @param entry: Pointer to the tower, or NULL for the head of the index.
+ * @param level: The lane.
+ */
+static DllIndexEntry **index_slot(DllIndex *index, DllIndexEntry *entry, size_t level)
+{
+    return entry ? &entry->next[level] : &index->next[level];
+}
+
+/*
+ * @brief: Returns the first slot of the tower table to probe for a node.
+ */
+static size_t index_hash(const DllIndex *index, const DllNode *node)
+{
+    uint64_t hash = ((uint64_t) (uintptr_t) node >> 4) * 0x9E3779B97F4A7C15ull;
+    return (size_t) (hash >> 32) & (index->towers_slots - 1);
+}
+
+/*
+ * @brief: Finds the tower of a node in O(1) expected time.
+ *
+ * @return: Pointer to the tower, or NULL if the node has none.
+ */
+static DllIndexEntry *index_find_tower(const DllIndex *index, const DllNode *node)
+{
+    if (index->towers_count == 0)
+        return NULL;
+
+    DllIndexEntry *entry = NULL;
+    for (size_t slot = index_hash(index, node); (entry = index->towers[slot]);
+            slot = (slot + 1) & (index->towers_slots - 1))
+    {
+        if (entry->node == node)
+            return entry;
+    }
+
+    return NULL;
+}
+
+/*
+ * @brief: Adds a tower to the tower table, which must have a free slot.
+ */
+static void index_map_tower(DllIndex *index, DllIndexEntry *entry)
+{
+    size_t slot = index_hash(index, entry->node);
+    while (index->towers[slot])
+        slot = (slot + 1) & (index->towers_slots - 1);
+
+    index->towers[slot] = entry;
+    ++index->towers_count;
+}
+
+/*
+ * @brief: Removes a tower from the tower table.
+ *
+ * The towers following it in its probe run are moved back, so that no
+ * lookup stops at the freed slot before reaching them.
+ */
+static void index_unmap_tower(DllIndex *index, DllIndexEntry *entry)
+{
+    size_t mask = index->towers_slots - 1;
+    size_t slot = index_hash(index, entry->node);
+    while (index->towers[slot] != entry)
+        slot = (slot + 1) & mask;
+
+    size_t next = slot;
+    size_t home = 0;
+    while (index->towers[next = (next + 1) & mask])
+    {
+        // A tower may fill the hole unless its home slot lies cyclically in ('slot', 'next'].
+        home = index_hash(index, index->towers[next]->node);
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            index->towers[slot] = index->towers[next];
+            slot = next;
+        }
+    }
+
+    index->towers[slot] = NULL;
+    --index->towers_count;
+}
+
+/*
+ * @brief: Refills the tower table from the lowest lane, after the towers have moved to other nodes.
+ */
+static void index_remap_towers(DllIndex *index)
+{
+    if (index->towers_slots > 0)
+        memset(index->towers, 0, index->towers_slots * sizeof(DllIndexEntry *));
+    index->towers_count = 0;
+
+    for (DllIndexEntry *entry = index->next[0]; entry; entry = entry->next[0])
+        index_map_tower(index, entry);
+}
+
+/*
+ * @brief: Makes sure the tower table has room for one more tower (it is kept at most half full).
+ *
+ * @return: 'true' on success, 'false' on failure (the table is unchanged).
+ */
+static bool index_reserve_tower(DllIndex *index)
+{
+    if (2 * (index->towers_count + 1) <= index->towers_slots)
+        return true;
+
+    size_t slots = index->towers_slots ? 2 * index->towers_slots : 16;
+    DllIndexEntry **towers = calloc(slots, sizeof(DllIndexEntry *));
+    if (!towers)
+        return false;
+
+    free(index->towers);
+    index->towers = towers;
+    index->towers_slots = slots;
+    index_remap_towers(index);
+    return true;
+}
+
+/*
+ * @brief: Draws the height of a new tower (each lane is taken with probability 1/4).
+ */
+static size_t index_random_height(DllIndex *index)
+{
+    uint32_t x = index->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    index->seed = x;
+
+    size_t height = 0;
+    while ((height < DLL_INDEX_MAX_LEVEL) && ((x & 3) == 0))
+    {
+        ++height;
+        x >>= 2;
+    }
+    return height;
+}
+
+/*
+ * @brief: Checks whether data lies before the searched position.
+ *
+ * @param upper: Compare as an upper bound ('data <= key') instead of a lower bound ('data < key').
+ */
+static bool precedes_key(const DllList *list, const void *data, const void *key, bool upper)
+{
+    int result = list->cmp(data, key);
+    return upper ? (result <= 0) : (result < 0);
+}
+
+/*
+ * @brief: Descends the index to the last towers preceding a key.
+ *
+ * @param list: Pointer to the list in sorted mode.
+ * @param key: The searched key.
+ * @param upper: Search for the upper bound instead of the lower bound.
+ * @param update: If not NULL, receives the last preceding tower on each lane in use.
+ * @return: The last preceding tower, or NULL if no tower precedes the key.
+ */
+static DllIndexEntry *index_descend(const DllList *list, const void *key, bool upper,
+        DllIndexEntry **update)
+{
+    DllIndex *index = list->index;
+    DllIndexEntry *entry = NULL;
+    DllIndexEntry *next = NULL;
+
+    for (size_t level = index->level; level-- > 0; )
+    {
+        while ((next = *index_slot(index, entry, level)) &&
+                precedes_key(list, next->node->data, key, upper))
+            entry = next;
+        if (update)
+            update[level] = entry;
+    }
+
+    return entry;
+}
+
+/*
+ * @brief: Finds the first node that does not precede a key.
+ *
+ * @param list: Pointer to the list in sorted mode.
+ * @param key: The searched key.
+ * @param upper: Search for the upper bound instead of the lower bound.
+ * @param update: If not NULL, receives the last preceding tower on each lane in use.
+ * @return: The found node, or the tail limiter if every node precedes the key.
+ */
+static DllNode *index_search(const DllList *list, const void *key, bool upper,
+        DllIndexEntry **update)
+{
+    DllIndexEntry *entry = index_descend(list, key, upper, update);
+    DllNode *node = entry ? entry->node->next : list->head->next;
+
+    // The rest of the way is covered on the lowest lane, the list itself.
+    while ((node != list->tail) && precedes_key(list, node->data, key, upper))
+        node = node->next;
+
+    return node;
+}
+
+/*
+ * @brief: Builds a tower of random height for a node linked into the list.
+ *
+ * A node left without a tower (by chance or for lack of memory) is still
+ * reachable through the lowest lane, so the index remains valid.
+ *
+ * @param index: Pointer to the index.
+ * @param node: Pointer to the node.
+ * @param update: The last towers preceding the node on each lane in use.
+ * @return: Pointer to the new tower, or NULL if the node got none.
+ */
+static DllIndexEntry *index_add(DllIndex *index, DllNode *node, DllIndexEntry **update)
+{
+    size_t height = index_random_height(index);
+    if ((height == 0) || !index_reserve_tower(index))
+        return NULL;
+
+    DllIndexEntry *entry = calloc(1, sizeof(DllIndexEntry) + 2 * height * sizeof(DllIndexEntry *));
+    if (!entry)
+        return NULL;
+
+    entry->node = node;
+    entry->height = height;
+    entry->prev = &entry->next[height];
+    index_map_tower(index, entry);
+
+    // New lanes start at the head of the index.
+    for (size_t level = index->level; level < height; ++level)
+        update[level] = NULL;
+    if (height > index->level)
+        index->level = height;
+
+    DllIndexEntry **slot = NULL;
+    for (size_t level = 0; level < height; ++level)
+    {
+        slot = index_slot(index, update[level], level);
+        entry->next[level] = *slot;
+        entry->prev[level] = update[level];
+        if (*slot)
+            (*slot)->prev[level] = entry;
+        *slot = entry;
+    }
+
+    return entry;
+}
+
+/*
+ * @brief: Removes the tower of a node that is about to leave the list.
+ *
+ * The tower is found through the tower table and unlinked through its
+ * 'prev' links, so the cost does not depend on how many nodes are equal
+ * to this one.
+ *
+ * @param list: Pointer to the list in sorted mode.
+ * @param node: Pointer to the node.
+ */
+static void index_remove(DllList *list, DllNode *node)
+{
+    DllIndex *index = list->index;
+    DllIndexEntry *entry = index_find_tower(index, node);
+    if (!entry)
+        return;
+
+    index_unmap_tower(index, entry);
+    DllIndexEntry *next = NULL;
+    for (size_t level = 0; level < entry->height; ++level)
+    {
+        next = entry->next[level];
+        *index_slot(index, entry->prev[level], level) = next;
+        if (next)
+            next->prev[level] = entry->prev[level];
+    }
+
+    while ((index->level > 0) && !index->next[index->level - 1])
+        --index->level;
+    free(entry);
+}
+
+/*
+ * @brief: Frees a chain of towers linked through 'next[0]'.
+ */
+static void index_free_chain(DllIndexEntry *entry)
+{
+    DllIndexEntry *temp = NULL;
+    while (entry)
+    {
+        temp = entry;
+        entry = entry->next[0];
+        free(temp);
+    }
+}
+
+/*
+ * @brief: Removes all towers from the index.
+ */
+static void index_clear(DllIndex *index)
+{
+    index_free_chain(index->next[0]);
+    for (size_t level = 0; level < index->level; ++level)
+        index->next[level] = NULL;
+    index->level = 0;
+    index_remap_towers(index);
+}
+
+/*
+ * @brief: Moves all towers of the index to its pending chain.
+ *
+ * Only the last tower has to be found, which takes O(log n) steps.
+ */
+static void index_retire(DllIndex *index)
+{
+    if (index->level == 0)
+        return;
+
+    DllIndexEntry *last = NULL;
+    DllIndexEntry *next = NULL;
+    for (size_t level = index->level; level-- > 0; )
+    {
+        while ((next = *index_slot(index, last, level)))
+            last = next;
+    }
+
+    last->next[0] = index->pending;
+    index->pending = index->next[0];
+    for (size_t level = 0; level < index->level; ++level)
+        index->next[level] = NULL;
+    index->level = 0;
+    index_remap_towers(index);
+}
+
+/*
+ * @brief: Turns on the sorted mode of a list that is already sorted.
+ *
+ * @param list: Pointer to the list sorted according to 'cmp'.
+ * @param cmp: Pointer to the comparison function.
+ * @return: 'true' on success, 'false' on failure.
+ */
+static bool enter_sorted_mode(DllList *list, int (*cmp) (const void *, const void *))
+{
+    DllIndex *index = calloc(1, sizeof(DllIndex));
+    if (!index)
+        return false;
+
+    index->seed = 2463534242u;
+    list->index = index;
+    list->cmp = cmp;
+
+    // The nodes are visited in order, so each tower is added after the last ones.
+    DllIndexEntry *last[DLL_INDEX_MAX_LEVEL] = { NULL };
+    DllIndexEntry *entry = NULL;
+    for (DllNode *node = list->head->next; node != list->tail; node = node->next)
+    {
+        entry = index_add(index, node, last);
+        for (size_t level = 0; entry && (level < entry->height); ++level)
+            last[level] = entry;
+    }
+
+    return true;
+}
+
+/*
+ * @brief: Turns off the sorted mode, the order of the elements is kept.
+ *
+ * Called by every operation that may break the order of a sorted list.
+ */
+static void leave_sorted_mode(DllList *list)
+{
+    if (!list->index)
+        return;
+
+    index_clear(list->index);
+    index_free_chain(list->index->pending);
+    free(list->index->towers);
+    free(list->index);
+    list->index = NULL;
+    list->cmp = NULL;
+}
+
+/* Number of slots the ring of a deque starts with. */
+#define DLL_RING_MIN_SLOTS 16
+
+/*
+ * @brief: Circular array holding the elements of a list in deque mode.
+ */
+struct DllRing {
+    void **items;           ///< The slots (their number is a power of two).
+    size_t slots;           ///< Number of slots.
+    size_t first;           ///< Slot of the first element.
+    size_t count;           ///< Number of elements of a detached ring (a live ring uses the list's 'size').
+    struct DllRing *next;   ///< The next detached ring awaiting reclamation.
+};
+
+/*
+ * @brief: Returns the slot of the element at the given position of a ring.
+ */
+static size_t ring_slot(const DllRing *ring, size_t index)
+{
+    return (ring->first + index) & (ring->slots - 1);
+}
+
+/*
+ * @brief: Makes room for one more element in the ring of a list.
+ *
+ * @param list: Pointer to the list in deque mode.
+ * @return: 'true' on success, 'false' on failure.
+ */
+static bool ring_reserve(DllList *list)
+{
+    DllRing *ring = list->ring;
+    if (list->size < ring->slots)
+        return true;
+
+    size_t slots = ring->slots ? 2 * ring->slots : DLL_RING_MIN_SLOTS;
+    void **items = malloc(slots * sizeof(void *));
+    if (!items)
+        return false;
+
+    // The elements are unrolled to the start of the new array.
+    for (size_t i = 0; i < list->size; ++i)
+        items[i] = ring->items[ring_slot(ring, i)];
+
+    free(ring->items);
+    ring->items = items;
+    ring->slots = slots;
+    ring->first = 0;
+    return true;
+}
+
+/*
+ * @brief: Adds an element to one of the ends of a list in deque mode.
+ *
+ * @param list: Pointer to the list in deque mode.
+ * @param front: Add to the front instead of the back.
+ * @param data: Pointer to the data.
+ * @param take: Adopt the data instead of copying it.
+ * @return: 'true' on success, 'false' on failure.
+ */
+static bool ring_push(DllList *list, bool front, const void *data, bool take)
+{
+    if (!ring_reserve(list))
+        return false;
+
+    void *item = (void *) data;
+    if (!take && list->copy)
+    {
+        item = list->copy(data);
+        if (!item)
+            return false;
+    }
+
+    DllRing *ring = list->ring;
+    if (front)
+    {
+        ring->first = (ring->first - 1) & (ring->slots - 1);
+        ring->items[ring->first] = item;
+    }
+    else
+        ring->items[ring_slot(ring, list->size)] = item;
+
+    ++list->size;
+    return true;
+}
+
+/*
+ * @brief: Removes an element from one of the ends of a non-empty list in deque mode.
+ *
+ * @param list: Pointer to the list in deque mode.
+ * @param front: Remove from the front instead of the back.
+ * @return: Pointer to the data of the removed element.
+ */
+static void *ring_pop(DllList *list, bool front)
+{
+    DllRing *ring = list->ring;
+    void *data = NULL;
+
+    if (front)
+    {
+        data = ring->items[ring->first];
+        ring->first = ring_slot(ring, 1);
+    }
+    else
+        data = ring->items[ring_slot(ring, list->size - 1)];
+
+    --list->size;
+    return data;
+}
+
+/*
+ * @brief: Destroys up to 'budget' elements of a detached ring, starting from the first one.
+ *
+ * @return: The number of destroyed elements.
+ */
+static size_t ring_reclaim(DllList *list, DllRing *ring, size_t budget)
+{
+    size_t released = 0;
+
+    while ((ring->count > 0) && ((budget == 0) || (released < budget)))
+    {
+        list->destroy(ring->items[ring->first]);
+        ring->first = ring_slot(ring, 1);
+        --ring->count;
+        ++released;
+    }
+
+    return released;
+}
+
+DllList *dll_create_deque(void * (*copy) (const void *data),
+        void (*destroy) (void *data), size_t capacity)
+{
+    DllList *list = dll_create(copy, destroy);
+    if (!list)
+        return NULL;
+
+    // The slots are allocated with the first element.
+    list->ring = calloc(1, sizeof(DllRing));
+    if (!list->ring)
+    {
+        dll_destroy(list);
+        return NULL;
+    }
+
+    list->capacity = capacity;
+    return list;
+}
+
 void dll_clear(DllList *list)
+{
+    if (!list)
+        return;
+
+    dll_reclaim(list, 0);
+    if (list->size == 0)
+        return;
+
+    if (list->ring)
+    {
+        while (list->destroy && (list->size > 0))
+            list->destroy(ring_pop(list, true));
+        list->ring->first = 0;
+        list->size = 0;
+        return;
+    }
+
+    DllNode *cur_node = list->head->next;
+    DllNode *temp_node = NULL;
+
+    /* We go throught the list from beginning to end, deleting nodes and,
+     * if necessary, destroying data. */
+    while(cur_node != list->tail)
+    {
+        temp_node = cur_node;
+        cur_node = cur_node->next;
+
+        drop_data(list, temp_node->data);
+        free_node(list, temp_node);
+    }
+
+    if (list->index)
+        index_clear(list->index);
+
+    // The limiters point to each other.
+    list->head->next = list->tail;
+    list->tail->prev = list->head;
+    list->size = 0;
+}
+
+void dll_clear_deferred(DllList *list)
+{
+    if (!list || (list->size == 0))
+        return;
+
+    /* The slots of a deque are detached together with its elements and
+     * replaced by an empty ring. */
+    if (list->ring)
+    {
+        DllRing *ring = list->destroy ? calloc(1, sizeof(DllRing)) : NULL;
+        if (!ring)
+        {
+            dll_clear(list);
+            return;
+        }
+
+        list->ring->count = list->size;
+        list->ring->next = list->pending_rings;
+        list->pending_rings = list->ring;
+        list->ring = ring;
+        list->pending_size += list->size;
+        list->size = 0;
+        return;
+    }
+
+    /* The detached chain is prepended to the pending chain, so only the
+     * first and the last node of the list are touched. */
+    DllNode *first = list->head->next;
+    DllNode *last = list->tail->prev;
+
+    last->next = list->pending;
+    list->pending = first;
+    list->pending_size += list->size;
+
+    if (list->index)
+        index_retire(list->index);
+
+    // The limiters point to each other.
+    list->head->next = list->tail;
+    list->tail->prev = list->head;
+    list->size = 0;
+}
+
+size_t dll_reclaim(DllList *list, size_t budget)
+{
+    if (!list)
+        return 0;
+
+    DllNode *temp_node = NULL;
+    DllIndexEntry *temp_entry = NULL;
+    size_t released = 0;
+
+    while (list->pending && ((budget == 0) || (released < budget)))
+    {
+        temp_node = list->pending;
+        list->pending = temp_node->next;
+
+        drop_data(list, temp_node->data);
+        free_node(list, temp_node);
+        ++released;
+
+        // There are never more pending towers than pending nodes.
+        if (list->index && list->index->pending)
+        {
+            temp_entry = list->index->pending;
+            list->index->pending = temp_entry->next[0];
+            free(temp_entry);
+        }
+    }
+
+    DllRing *temp_ring = NULL;
+    while (list->pending_rings && ((budget == 0) || (released < budget)))
+    {
+        temp_ring = list->pending_rings;
+        released += ring_reclaim(list, temp_ring, budget ? budget - released : 0);
+        if (temp_ring->count > 0)
+            break;
+
+        list->pending_rings = temp_ring->next;
+        free(temp_ring->items);
+        free(temp_ring);
+    }
+
+    list->pending_size -= released;
+    return list->pending_size;
+}
+
+void dll_destroy(DllList *list)
+{
+    if (!list)
+        return;
+
+    dll_clear(list);
+    leave_sorted_mode(list);
+    if (list->ring)
+    {
+        free(list->ring->items);
+        free(list->ring);
+    }
+
+    if (list->blocks)
+    {
+        for (size_t i = 0; i < list->blocks->count; ++i)
+            free(list->blocks->items[i]);
+        free(list->blocks);
+    }
+
+    free(list->head);
+    free(list->tail);
+    free(list);
+    list = NULL;
+}
+
+/*
+ * @brief: Creates a new node that owns the given data.
+ *
+ * @param list: Pointer to the list to which the created node will be added.
+ * @param data: Pointer to data.
+ * @return: A pointer to the node, or NULL on failure.
+ */
+static DllNode *create_node(const DllList *list, void *data)
+{
+    DllNode *new_node = alloc_node(list);
+    if (!new_node)
+        return NULL;
+
+    new_node->data = data;
+    return new_node;
+}
+
+/*
+ * @brief: Creates a new node and copies the data.
+ * 
+ * @param list: Pointer to the list to which the created node will be added.
+ * @param data: Pointer to data.
+ * @return: A pointer to the node, or NULL on failure.
+ */
+static DllNode *create_node_and_copy_data(const DllList *list, const void *data)
+{
+    if (!list->copy)
+        return create_node(list, (void *) data);
+
+    void *new_data = list->copy(data);
+    if (!new_data)
+        return NULL;
+
+    DllNode *new_node = create_node(list, new_data);
+    if (!new_node)
+        list->destroy(new_data);
+
+    return new_node;
+}
+
+/*
+ * @brief: Links a new node into the list before the given node.
+ *
+ * @param list: Pointer to the list.
+ * @param before: The node before which the new node is linked.
+ * @param new_node: Pointer to the node being linked.
+ */
+static void link_node(DllList *list, DllNode *before, DllNode *new_node)
+{
+    new_node->prev = before->prev;
+    new_node->next = before;
+    before->prev->next = new_node;
+    before->prev = new_node;
+
+    ++list->size;
+}
+
+/*
+ * @brief: Unlinks a node from the list and frees it.
+ *
+ * @param list: Pointer to the list.
+ * @param node: Pointer to the node being removed.
+ * @return: Pointer to the data of the removed node.
+ */
+static void *release_node(DllList *list, DllNode *node)
+{
+    void *data = node->data;
+
+    if (list->index)
+        index_remove(list, node);
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    --list->size;
+
+    free_node(list, node);
+    return data;
+}
+
+/*
+ * @brief: Switches a list from deque mode to linked nodes.
+ *
+ * Called by every operation that works in the middle of the list or
+ * relinks its nodes. The list keeps its capacity.
+ *
+ * @param list: Pointer to the list.
+ * @return: 'true' on success (or if the list is not in deque mode), 'false' on failure
+ * (the list is unchanged).
+ */
+static bool leave_deque_mode(DllList *list)
+{
+    DllRing *ring = list->ring;
+    if (!ring)
+        return true;
+
+    size_t size = list->size;
+    DllNode *new_node = NULL;
+
+    list->size = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        new_node = create_node(list, ring->items[ring_slot(ring, i)]);
+        if (!new_node)
+        {
+            while (list->size > 0)
+                release_node(list, list->tail->prev);
+            list->size = size;
+            return false;
+        }
+        link_node(list, list->tail, new_node);
+    }
+
+    free(ring->items);
+    free(ring);
+    list->ring = NULL;
+    return true;
+}
+
+/*
+ * @brief: Checks whether the list has reached its capacity.
+ */
+static bool is_full(const DllList *list)
+{
+    return (list->capacity > 0) && (list->size >= list->capacity);
+}
+
+bool dll_push_front(DllList *list, const void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+    if (list->ring)
+        return ring_push(list, true, data, false);
+
+    DllNode *new_node = create_node_and_copy_data(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, list->head->next, new_node);
+    return true;
+}
+
+bool dll_push_back(DllList *list, const void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+    if (list->ring)
+        return ring_push(list, false, data, false);
+
+    DllNode *new_node = create_node_and_copy_data(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, list->tail, new_node);
+    return true;
+}
+
+bool dll_push_front_take(DllList *list, void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+    if (list->ring)
+        return ring_push(list, true, data, true);
+
+    DllNode *new_node = create_node(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, list->head->next, new_node);
+    return true;
+}
+
+bool dll_push_back_take(DllList *list, void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+    if (list->ring)
+        return ring_push(list, false, data, true);
+
+    DllNode *new_node = create_node(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, list->tail, new_node);
+    return true;
+}
+
+/*
+ * @brief: Search for a node by its index.
+ *
+ * @param list: A pointer to the list.
+ * @param index: Index of the node being searched.
+ * @return: Pointer to node, or NULL on failure.
+ */
+static DllNode *dll_get_node_at(const DllList *list, size_t index)
+{
+    if (!list)
+        return NULL;
+
+    DllNode *node = NULL;
+
+    /* We go throught the list from the beginning to the end of from the end
+     * to the beginning, depending on the distance of the desired node from
+     * the middle of the list */
+    if (index <= (list->size / 2))
+    {
+        node = list->head->next;
+        for (int i = 0; i < index; ++i)
+            node = node->next;
+    }
+    else
+    {
+        node = list->tail;
+        for (int i = list->size; i > index; --i)
+            node = node->prev;
+    }
+
+    return node;
+}
+
+bool dll_insert_at(DllList *list, size_t index, const void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+
+    if (index > list->size)
+        index = list->size;
+
+    // A deque takes insertions at its ends, anything else turns it into a linked list.
+    if (list->ring && ((index == 0) || (index == list->size)))
+        return ring_push(list, index == 0, data, false);
+    if (!leave_deque_mode(list))
+        return false;
+
+    DllNode *new_node = create_node_and_copy_data(list, data);
+    if (!new_node)
+        return false;
+
+    // The node before which a new node should be insert.
+    link_node(list, dll_get_node_at(list, index), new_node);
+    return true;
+}
+
+bool dll_insert_at_take(DllList *list, size_t index, void *data)
+{
+    if (!list || is_full(list))
+        return false;
+
+    leave_sorted_mode(list);
+
+    if (index > list->size)
+        index = list->size;
+
+    // A deque takes insertions at its ends, anything else turns it into a linked list.
+    if (list->ring && ((index == 0) || (index == list->size)))
+        return ring_push(list, index == 0, data, true);
+    if (!leave_deque_mode(list))
+        return false;
+
+    DllNode *new_node = create_node(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, dll_get_node_at(list, index), new_node);
+    return true;
+}
+
+bool dll_remove_at(DllList *list, size_t index)
+{
+    if (!list || (list->size == 0) || (list->size <= index))
+        return false;
+
+    void *data = NULL;
+    if (list->ring && ((index == 0) || (index == list->size - 1)))
+        data = ring_pop(list, index == 0);
+    else if (leave_deque_mode(list))
+        data = release_node(list, dll_get_node_at(list, index));
+    else
+        return false;
+
+    // If deep coping is used delete the node data.
+    drop_data(list, data);
+
+    return true;
+}
+
+void * dll_extract_at(DllList *list, size_t index)
+{
+    if (!list || (list->size == 0) || (list->size <= index))
+        return NULL;
+
+    if (list->ring && ((index == 0) || (index == list->size - 1)))
+        return ring_pop(list, index == 0);
+    if (!leave_deque_mode(list))
+        return NULL;
+
+    DllNode *node = dll_get_node_at(list, index);
+    if (!own_data(list, node))
+        return NULL;
+
+    return release_node(list, node);
+}
+
+void * dll_pop_front(DllList *list)
 {
     if (!list || (list->size == 0))
+        return NULL;
+    if (list->ring)
+        return ring_pop(list, true);
+    if (!own_data(list, list->head->next))
+        return NULL;
+
+    return release_node(list, list->head->next);
+}
+
+void * dll_pop_back(DllList *list)
+{
+    if(!list || (list->size == 0))
+        return NULL;
+    if (list->ring)
+        return ring_pop(list, false);
+    if (!own_data(list, list->tail->prev))
+        return NULL;
+
+    return release_node(list, list->tail->prev);
+}
+
+void * dll_get_at(const DllList *list, size_t index)
+{
+    if (!list || (list->size == 0) || (index >= list->size))
+        return NULL;
+    if (list->ring)
+        return list->ring->items[ring_slot(list->ring, index)];
+
+	DllNode *node = dll_get_node_at(list, index);
+
+    return node->data;
+}
+
+bool dll_is_empty(const DllList *list)
+{
+    if (!list)
+        return true;
+    return list->size == 0;
+}
+
+bool dll_is_full(const DllList *list)
+{
+    if (!list)
+        return false;
+    return is_full(list);
+}
+
+size_t dll_size(const DllList *list)
+{
+    if (!list)
+        return 0;
+    return list->size;
+}
+
+void dll_reverse(DllList *list)
+{
+    if (!list || (list->size < 2))
         return;
 
-    DllNode *cur_node = list->head->next;
-    DllNode *temp_node = NULL;
+    leave_sorted_mode(list);
 
-    /* We go throught the list from beginning to end, deleting nodes and,
-     * if necessary, destroying data. */
-    while(cur_node != list->tail)
+    if (list->ring)
     {
-        temp_node = cur_node;
-        cur_node = cur_node->next;
+        DllRing *ring = list->ring;
+        void *temp = NULL;
+        for (size_t i = 0, j = list->size - 1; i < j; ++i, --j)
+        {
+            temp = ring->items[ring_slot(ring, i)];
+            ring->items[ring_slot(ring, i)] = ring->items[ring_slot(ring, j)];
+            ring->items[ring_slot(ring, j)] = temp;
+        }
+        return;
+    }
+
+	DllNode *node_1 = list->head;
+	DllNode *node_2 = list->tail;
+    void *temp = NULL;
+
+    int iter = (list->size / 2) + 1;
+    for (int i = 0; i < iter; ++i)
+    {
+        temp = node_1->data;
+        node_1->data = node_2->data;
+        node_2->data = temp;
+        node_1 = node_1->next;
+        node_2 = node_2->prev;
+    }
+}
 
-        if (list->destroy)
-            list->destroy(temp_node->data);
-        free(temp_node);
+void dll_for_each(DllList *list, void (*func) (void *, void *), void *arg)
+{
+    if (list->ring)
+    {
+        for (size_t i = 0; i < list->size; ++i)
+            func(list->ring->items[ring_slot(list->ring, i)], arg);
+        return;
     }
 
-    // The limiters point to each other.
-    list->head->next = list->tail;
-    list->tail->prev = list->head;
-    list->size = 0;
+	DllNode *cur_node = list->head->next;
+    while(cur_node->next != NULL)
+    {
+        func(cur_node->data, arg);
+        cur_node = cur_node->next;
+    }
 }
 
-void dll_destroy(DllList *list)
+DllList * dll_copy(const DllList *list)
 {
     if (!list)
+        return NULL;
+
+    DllList *new_list = NULL;
+    if (list->ring)
+    {
+        new_list = dll_create_deque(list->copy, list->destroy, list->capacity);
+        if (!new_list)
+            return NULL;
+
+        for (size_t i = 0; i < list->size; ++i)
+        {
+            if (!dll_push_back(new_list, list->ring->items[ring_slot(list->ring, i)]))
+            {
+                dll_destroy(new_list);
+                return NULL;
+            }
+        }
+        return new_list;
+    }
+
+    new_list = dll_create(list->copy, list->destroy);
+    if (!new_list)
+        return NULL;
+    new_list->capacity = list->capacity;
+
+	DllNode *cur = list->head->next;
+    while (cur->next != NULL)
+    {
+        if (!dll_push_back(new_list, cur->data))
+        {
+            dll_destroy(new_list);
+            return NULL;
+        }
+        cur = cur->next;
+    }
+
+    // The copy is already in order, only its index has to be built.
+    if (list->index && !enter_sorted_mode(new_list, list->cmp))
+    {
+        dll_destroy(new_list);
+        return NULL;
+    }
+
+    return new_list;
+}
+
+/*
+ * @brief: Swaps nodes.
+ *
+ * @param node_1: Pointer to the first node.
+ * @param node_2: Pointer to the second node.
+ */
+void swap_node(DllNode *node_1, DllNode *node_2)
+{
+    node_1->next = node_2->next;
+    node_2->next->prev = node_1;
+
+    node_1->prev->next = node_2;
+    node_2->prev = node_1->prev;
+    node_1->prev = node_2;
+    node_2->next = node_1;
+}
+
+void dll_bubble_sort(DllList *list, int (*cmp) (const void *, const void *))
+{
+    if (!list || (list->size < 2))
         return;
 
-    dll_clear(list);
-    free(list->head);
-    free(list->tail);
-    free(list);
-    list = NULL;
+    leave_sorted_mode(list);
+    if (!leave_deque_mode(list))
+        return;
+
+    /* The nodes before 'head_stop' and after 'tail_stop' are already in
+     * place. Passes go in both directions, carrying the largest node of the
+     * unsorted part to its end and then the smallest one to its beginning.
+     * Only strictly greater nodes are swapped, so equal ones keep their order. */
+	DllNode *head_stop = list->head;
+	DllNode *tail_stop = list->tail;
+	DllNode *node = NULL;
+    bool is_sorted = false;
+
+    while (!is_sorted && (head_stop->next != tail_stop))
+    {
+        is_sorted = true;
+        node = head_stop->next;
+        while (node->next != tail_stop)
+        {
+            if (cmp(node->data, node->next->data) > 0)
+            {
+                is_sorted = false;
+                swap_node(node, node->next);
+            }
+            else
+                node = node->next;
+        }
+        tail_stop = node;
+
+        if (is_sorted || (head_stop->next == tail_stop))
+            break;
+
+        is_sorted = true;
+        node = tail_stop->prev;
+        while (node->prev != head_stop)
+        {
+            if (cmp(node->prev->data, node->data) > 0)
+            {
+                is_sorted = false;
+                swap_node(node->prev, node);
+            }
+            else
+                node = node->prev;
+        }
+        head_stop = node;
+    }
 }
 
 /*
- * @brief: Creates a new node and copies the data.
- * 
- * @param list: Pointer to the list to which the created node will be added.
- * @param data: Pointer to data.
- * @return: A pointer to the node, or NULL on failure.
+ * @brief: Merges two sorted chains of nodes.
+ *
+ * The chains are linked only through 'next' and terminated by NULL. Equal
+ * elements keep their order: nodes of the left chain go first.
+ *
+ * @param left_part: The first node of the left chain.
+ * @param right_part: The first node of the right chain.
+ * @param cmp: Pointer to the comparison function.
+ * @return: The first node of the merged chain.
  */
-static DllNode *create_node_and_copy_data(const DllList *list, const void *data)
+static DllNode *merge_chains(DllNode *left_part, DllNode *right_part,
+        int (*cmp) (const void *, const void *))
 {
-    DllNode *new_node = calloc(1, sizeof(DllNode));
-    if (!new_node)
-        return NULL;
+    DllNode unity = { .data = NULL, .prev = NULL, .next = NULL };
+    DllNode *unity_end = &unity;
 
-    if (list->copy)
+    // We take the smallest node and add it to the end of the united part.
+    while (left_part && right_part)
     {
-        new_node->data = list->copy(data);
-        if (!new_node->data)
+        if (cmp(right_part->data, left_part->data) < 0)
         {
-            free(new_node);
-            return NULL;
+            unity_end->next = right_part;
+            right_part = right_part->next;
         }
+        else
+        {
+            unity_end->next = left_part;
+            left_part = left_part->next;
+        }
+        unity_end = unity_end->next;
     }
-    else
-        new_node->data = (void *) data;
 
-    return new_node;
+    // The remaining part is added without any additional checks.
+    unity_end->next = left_part ? left_part : right_part;
+
+    return unity.next;
+}
+
+/*
+ * @brief: Sorts a chain of nodes linked through 'next' and terminated by NULL.
+ *
+ * @param start: The first node of the chain.
+ * @param size: Number of nodes in the chain.
+ * @param cmp: Pointer to the comparison function.
+ * @return: The first node of the sorted chain.
+ */
+static DllNode *merge_sort(DllNode *start, size_t size, int (*cmp) (const void *, const void *))
+{
+    if (size < 2)
+        return start;
+
+    size_t left_part_size = size / 2;
+
+    // Find the last node of the left side and cut the chain after it.
+    DllNode *left_part_end = start;
+    for (size_t i = 1; i < left_part_size; ++i)
+        left_part_end = left_part_end->next;
+    DllNode *right_part_start = left_part_end->next;
+    left_part_end->next = NULL;
+
+    // Recursivery sort the right and left parts and combine them.
+    DllNode *left_part = merge_sort(start, left_part_size, cmp);
+    DllNode *right_part = merge_sort(right_part_start, size - left_part_size, cmp);
+
+    return merge_chains(left_part, right_part, cmp);
+}
+
+/*
+ * @brief: Detaches all nodes of the list as a chain terminated by NULL.
+ *
+ * @param list: Pointer to the list (it becomes empty).
+ * @return: The first node of the chain, or NULL if the list is empty.
+ */
+static DllNode *detach_chain(DllList *list)
+{
+    if (list->size == 0)
+        return NULL;
+
+    DllNode *chain = list->head->next;
+    list->tail->prev->next = NULL;
+
+    list->head->next = list->tail;
+    list->tail->prev = list->head;
+    list->size = 0;
+
+    return chain;
 }
 
-bool dll_push_front(DllList *list, const void *data)
+/*
+ * @brief: Links a chain of nodes into an empty list, restoring the 'prev' pointers.
+ *
+ * @param list: Pointer to the empty list.
+ * @param chain: The first node of a chain linked through 'next' and terminated by NULL.
+ * @param size: Number of nodes in the chain.
+ */
+static void attach_chain(DllList *list, DllNode *chain, size_t size)
 {
-    if (!list)
-        return false;
-
-    DllNode *new_node = create_node_and_copy_data(list, data);
-    if (!new_node)
-        return false;
+    DllNode *prev = list->head;
 
-    new_node->next = list->head->next;
-    new_node->prev = list->head;
-    list->head->next->prev = new_node;
-    list->head->next = new_node;
-    
-    ++list->size;
-    return true;
+    prev->next = chain;
+    while (chain)
+    {
+        chain->prev = prev;
+        prev = chain;
+        chain = chain->next;
+    }
+    prev->next = list->tail;
+    list->tail->prev = prev;
+    list->size = size;
 }
 
-bool dll_push_back(DllList *list, const void *data)
+void dll_sort(DllList *list, int (*cmp) (const void *, const void *))
 {
-    if (!list)
-        return false;
+    if (!list || list->size < 2 || !leave_deque_mode(list))
+        return;
 
-    DllNode *new_node = create_node_and_copy_data(list, data);
-    if (!new_node)
-        return false;
-    
-    new_node->prev = list->tail->prev;
-    new_node->next = list->tail;
-    list->tail->prev->next = new_node;
-    list->tail->prev = new_node;
+    // A list sorted again by its own function stays in sorted mode.
+    int (*sorted_by) (const void *, const void *) = list->cmp;
+    leave_sorted_mode(list);
 
-    ++list->size;
-    return true;
+    size_t size = list->size;
+    DllNode *chain = detach_chain(list);
+
+    attach_chain(list, merge_sort(chain, size, cmp), size);
+
+    if (sorted_by == cmp)
+        enter_sorted_mode(list, cmp);
 }
 
 /*
- * @brief: Search for a node by its index.
+ * @brief: Merges the nodes of a sorted linked list into another one.
  *
- * @param list: A pointer to the list.
- * @param index: Index of the node being searched.
- * @return: Pointer to node, or NULL on failure.
+ * @param dst: Pointer to the list receiving the nodes.
+ * @param src: Pointer to the list giving away its nodes.
+ * @param cmp: Pointer to the comparison function.
  */
-static DllNode *dll_get_node_at(const DllList *list, size_t index)
+static void merge_lists(DllList *dst, DllList *src, int (*cmp) (const void *, const void *))
 {
-    if (!list)
-        return NULL;
-
-    DllNode *node = NULL;
+    leave_sorted_mode(dst);
+    if (src->index)
+        index_clear(src->index);
+    adopt_blocks(dst, src);
 
-    /* We go throught the list from the beginning to the end of from the end
-     * to the beginning, depending on the distance of the desired node from
-     * the middle of the list */
-    if (index <= (list->size / 2))
-    {
-        node = list->head->next;
-        for (int i = 0; i < index; ++i)
-            node = node->next;
-    }
-    else
-    {
-        node = list->tail;
-        for (int i = list->size; i > index; --i)
-            node = node->prev;
-    }
+    size_t size = dst->size + src->size;
+    DllNode *left_part = detach_chain(dst);
+    DllNode *right_part = detach_chain(src);
 
-    return node;
+    attach_chain(dst, merge_chains(left_part, right_part, cmp), size);
 }
 
-bool dll_insert_at(DllList *list, size_t index, const void *data)
+bool dll_merge(DllList *dst, DllList *src, int (*cmp) (const void *, const void *))
 {
-    if (!list)
+    if (!dst || !src || !cmp || (dst == src))
         return false;
 
-    if (index > list->size)
-        index = list->size;
-
-    DllNode *new_node = create_node_and_copy_data(list, data);
-    if (!new_node)
+    // Nodes can move between lists only if both lists own the data the same way.
+    if ((dst->copy != src->copy) || (dst->destroy != src->destroy))
         return false;
 
-    DllNode *before = dll_get_node_at(list, index); // The node before which a new node should be insert.
-    DllNode *after = before->prev;                  // The node after which a new node must be inserted.
+    if ((dst->capacity > 0) && (dst->size + src->size > dst->capacity))
+        return false;
 
-    // Switching the pointers
-    new_node->prev = after;
-    new_node->next = before;
-    after->next = new_node;
-    before->prev = new_node;
+    if (!leave_deque_mode(dst) || !leave_deque_mode(src))
+        return false;
+    if (!reserve_blocks(dst, blocks_to_adopt(src)))
+        return false;
 
-    ++list->size;
+    // A list merged into by its own function stays in sorted mode.
+    int (*sorted_by) (const void *, const void *) = dst->cmp;
+    merge_lists(dst, src, cmp);
+    if (sorted_by == cmp)
+        enter_sorted_mode(dst, cmp);
     return true;
 }
 
-bool dll_remove_at(DllList *list, size_t index)
+bool dll_splice_front(DllList *dst, DllList *src, size_t count)
 {
-    if (!list || (list->size == 0) || (list->size <= index))
+    if (!dst || !src || (dst == src))
         return false;
 
-    DllNode *del_node = dll_get_node_at(list, index); // The node to be removed.
-	DllNode *before = del_node->prev;                 // The node before the node being deleted
-	DllNode *after = del_node->next;                  // The node after the node being deleted.
+    // Nodes can move between lists only if both lists own the data the same way.
+    if ((dst->copy != src->copy) || (dst->destroy != src->destroy))
+        return false;
 
-    // If deep coping is used delete the node data.
-    if (list->destroy)
-        list->destroy(del_node->data);
+    if (count > src->size)
+        count = src->size;
+    if (count == 0)
+        return true;
 
-    // We free the memory occupied by the node and redirect the pointers.
-    free(del_node);
-    before->next = after;
-    after->prev = before;
+    if ((dst->capacity > 0) && (dst->size + count > dst->capacity))
+        return false;
 
-    --list->size;
-    return true;
-}
+    // The blocks of 'src' can only be handed over together with all of its nodes.
+    if (src->blocks && (count < src->size))
+        return false;
 
-void * dll_pop_front(DllList *list)
-{
-    if (!list || (list->size == 0))
-        return NULL;
+    if (!leave_deque_mode(dst) || !leave_deque_mode(src))
+        return false;
+    if (!reserve_blocks(dst, blocks_to_adopt(src)))
+        return false;
+    leave_sorted_mode(dst);
+    leave_sorted_mode(src);
+    adopt_blocks(dst, src);
 
-    DllNode *temp = list->head->next;
-    void *data = temp->data;
+    // Only the last moved node has to be found, which is free when all of them move.
+    DllNode *first = src->head->next;
+    DllNode *last = (count == src->size) ? src->tail->prev : dll_get_node_at(src, count - 1);
 
-    list->head->next = temp->next;
-    temp->next->prev = list->head;
-    --list->size;
+    src->head->next = last->next;
+    last->next->prev = src->head;
+    src->size -= count;
 
-    free(temp);
-    return data;
+    first->prev = dst->tail->prev;
+    dst->tail->prev->next = first;
+    last->next = dst->tail;
+    dst->tail->prev = last;
+    dst->size += count;
+
+    return true;
 }
 
-void * dll_pop_back(DllList *list)
+bool dll_merge_k(DllList *dst, DllList **lists, size_t k, int (*cmp) (const void *, const void *))
 {
-    if(!list || (list->size == 0))
+    if (!dst || (!lists && k > 0) || !cmp)
         return false;
-    
-	DllNode *temp = list->tail->prev;
-    void *data = temp->data;
 
-    list->tail->prev = temp->prev;
-    temp->prev->next = list->tail;
-    --list->size;
+    size_t size = dst->size;
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (!lists[i] || (lists[i] == dst) ||
+                (lists[i]->copy != dst->copy) || (lists[i]->destroy != dst->destroy))
+            return false;
+        size += lists[i]->size;
+    }
 
-    free(temp);
-    return data;
-}
+    if ((dst->capacity > 0) && (size > dst->capacity))
+        return false;
 
-void * dll_get_at(const DllList *list, size_t index)
-{
-    if (!list || (list->size == 0) || (index >= list->size))
-        return NULL;
-    
-	DllNode *node = dll_get_node_at(list, index);
+    // Only the capacity of 'dst' matters, the other lists are merged directly.
+    if (!leave_deque_mode(dst))
+        return false;
+    for (size_t i = 0; i < k; ++i)
+    {
+        if (!leave_deque_mode(lists[i]))
+            return false;
+    }
 
-    return node->data;
+    /* All the blocks go to 'dst' up front, so that the pairwise merges
+     * below do not have to grow the tables of the intermediate lists. */
+    size_t blocks_count = 0;
+    for (size_t i = 0; i < k; ++i)
+        blocks_count += blocks_to_adopt(lists[i]);
+    if (!reserve_blocks(dst, blocks_count))
+        return false;
+    for (size_t i = 0; i < k; ++i)
+        adopt_blocks(dst, lists[i]);
+
+    /* Neighbouring lists are merged pairwise, doubling the distance between
+     * them on each round, so that every element takes part in log(k) merges
+     * and equal elements keep the order of the lists they came from. */
+    for (size_t step = 1; step < k; step *= 2)
+    {
+        for (size_t i = 0; i + step < k; i += 2 * step)
+            merge_lists(lists[i], lists[i + step], cmp);
+    }
+
+    // A list merged into by its own function stays in sorted mode.
+    int (*sorted_by) (const void *, const void *) = dst->cmp;
+    if (k > 0)
+        merge_lists(dst, lists[0], cmp);
+    if ((sorted_by == cmp) && !dst->index)
+        enter_sorted_mode(dst, cmp);
+    return true;
 }
 
-bool dll_is_empty(const DllList *list)
+bool dll_set_sorted(DllList *list, int (*cmp) (const void *, const void *))
 {
     if (!list)
+        return false;
+
+    leave_sorted_mode(list);
+    if (!cmp)
         return true;
-    return list->size == 0;
-}
+    if (!leave_deque_mode(list))
+        return false;
 
-size_t dll_size(const DllList *list)
-{
-    if (!list)
-        return 0;
-    return list->size;
+    dll_sort(list, cmp);
+    return enter_sorted_mode(list, cmp);
 }
 
-void dll_reverse(DllList *list)
+bool dll_insert_sorted(DllList *list, const void *data)
 {
-    if (!list || (list->size < 2))
-        return;
+    if (!list || !list->index || is_full(list))
+        return false;
 
-	DllNode *node_1 = list->head;
-	DllNode *node_2 = list->tail;
-    void *temp = NULL;
+    // The new node goes after all nodes equal to it.
+    DllIndexEntry *update[DLL_INDEX_MAX_LEVEL];
+    DllNode *before = index_search(list, data, true, update);
 
-    int iter = (list->size / 2) + 1;
-    for (int i = 0; i < iter; ++i)
-    {
-        temp = node_1->data;
-        node_1->data = node_2->data;
-        node_2->data = temp;
-        node_1 = node_1->next;
-        node_2 = node_2->prev;
-    }
+    DllNode *new_node = create_node_and_copy_data(list, data);
+    if (!new_node)
+        return false;
+
+    link_node(list, before, new_node);
+    index_add(list->index, new_node, update);
+    return true;
 }
 
-void dll_for_each(DllList *list, void (*func) (void *, void *), void *arg)
+void * dll_lower_bound(const DllList *list, const void *key)
 {
-	DllNode *cur_node = list->head->next;
-    while(cur_node->next != NULL)
-    {
-        func(cur_node->data, arg);
-        cur_node = cur_node->next;
-    }
+    if (!list || !list->index)
+        return NULL;
+
+    return index_search(list, key, false, NULL)->data;
 }
 
-DllList * dll_copy(const DllList *list)
+void * dll_upper_bound(const DllList *list, const void *key)
 {
-    if (!list)
+    if (!list || !list->index)
         return NULL;
 
-    DllList *new_list = dll_create(list->copy, list->destroy);
-    if (!new_list)
-        return NULL;
+    return index_search(list, key, true, NULL)->data;
+}
 
-	DllNode *cur = list->head->next;
-    while (cur->next != NULL)
+size_t dll_range(DllList *list, const void *low, const void *high,
+        void (*func) (void *, void *), void *arg)
+{
+    if (!list || !list->index)
+        return 0;
+
+    size_t count = 0;
+    DllNode *node = index_search(list, low, false, NULL);
+    while ((node != list->tail) && (list->cmp(node->data, high) < 0))
     {
-        if (!dll_push_back(new_list, cur->data))
-        {
-            dll_destroy(new_list);
-            return NULL;
-        }
-        cur = cur->next;
+        func(node->data, arg);
+        node = node->next;
+        ++count;
     }
 
-    return new_list;
+    return count;
 }
 
 /*
- * @brief: Swaps nodes.
- *
- * @param node_1: Pointer to the first node.
- * @param node_2: Pointer to the second node.
+ * @brief: Compares nodes by their addresses.
  */
-void swap_node(DllNode *node_1, DllNode *node_2)
+static int cmp_node_address(const void *item_1, const void *item_2)
 {
-    node_1->next = node_2->next;
-    node_2->next->prev = node_1;
+    uintptr_t address_1 = (uintptr_t) *((DllNode * const *) item_1);
+    uintptr_t address_2 = (uintptr_t) *((DllNode * const *) item_2);
 
-    node_1->prev->next = node_2;
-    node_2->prev = node_1->prev;
-    node_1->prev = node_2;
-    node_2->next = node_1;
+    return (address_1 > address_2) - (address_1 < address_2);
 }
 
-/*
- * @brief: Extracts a node from a list.
- *
- * @param node: Pointer to the node to be extracted.
- */
-static DllNode *extract_node(DllNode *node)
+bool dll_relink_by_address(DllList *list)
 {
-    node->prev->next = node->next;
-    node->next->prev = node->prev;
-    node->next = NULL;
-    node->prev = NULL;
+    if (!list)
+        return false;
 
-    return node;
-}
+    // The elements of a deque are already stored contiguously.
+    if ((list->size < 2) || list->ring)
+        return true;
 
-/*
- * @brief: Inserts a node into a position before or after a reference node.
- *
- * @param reference_node: Pointer to the node relative to which the insertion occurs.
- * @param insertion_node: Pointer to the node to be inserted.
- * @param position: Defines the position to insert. Before the anchor node if 'position > 0',
- * after the anchor node if 'position < 0'.
- */
-void insert_node(DllNode *reference_node, DllNode *insertion_node, int position)
-{
-    if (!reference_node || !insertion_node || position == 0)
-        return;
-    
-    if (position > 0)
+    size_t size = list->size;
+    DllNode **nodes = malloc(size * sizeof(DllNode *));
+    void **data = malloc(size * sizeof(void *));
+    if (!nodes || !data)
     {
-        insertion_node->next = reference_node;
-        insertion_node->prev = reference_node->prev;
-
-        reference_node->prev->next = insertion_node;
-        reference_node->prev = insertion_node;
+        free(nodes);
+        free(data);
+        return false;
     }
-    else
-    {
-        insertion_node->prev = reference_node;
-        insertion_node->next = reference_node->next;
 
-        reference_node->next->prev = insertion_node;
-        reference_node->next = insertion_node;
+    size_t i = 0;
+    for (DllNode *node = list->head->next; node != list->tail; node = node->next, ++i)
+    {
+        nodes[i] = node;
+        data[i] = node->data;
     }
-}
+    qsort(nodes, size, sizeof(DllNode *), cmp_node_address);
 
-void dll_bubble_sort(DllList *list, int (*cmp) (const void *, const void *))
-{
-	DllNode *min_max = NULL;
-	DllNode *head_stop = list->head;
-	DllNode *tail_stop = list->tail;
-	DllNode *item_1 = NULL;
-	DllNode *item_2 = NULL;
-    bool is_sorted = false;
-
-    while (!is_sorted)
+    /* The element at position i moves to the i-th node in memory, and so
+     * does its tower in the index. The towers are visited in list order. */
+    if (list->index)
     {
-        is_sorted = true;
-        item_1 = head_stop->next;
-        item_2 = item_1->next;
-        min_max = item_1;
-        while (item_2 != tail_stop)
+        DllIndexEntry *entry = list->index->next[0];
+        i = 0;
+        for (DllNode *node = list->head->next; entry && (node != list->tail); node = node->next, ++i)
         {
-            if (cmp(item_2->data, min_max->data) > 0)
-                min_max = item_2;
-            if (cmp(item_1->data, item_2->data) > 0)
+            if (entry->node == node)
             {
-                is_sorted = false;
-                swap_node(item_1, item_2);
+                entry->node = nodes[i];
+                entry = entry->next[0];
             }
-            item_1 = item_2;
-            item_2 = item_2->next;
         }
-        extract_node(min_max);
-        insert_node(tail_stop, min_max, 1);
-        tail_stop = min_max;
+        index_remap_towers(list->index);
+    }
 
-        is_sorted = true;
-        item_2 = tail_stop->prev;
-        item_1 = item_2->prev;
-        min_max = item_2;
-        while(item_1 != head_stop)
-        {
-            if (cmp(item_1->data, min_max->data) < 0)
-                min_max = item_1;
-            if (cmp(item_1->data, item_2->data) > 0)
-            {
-                is_sorted = false;
-                swap_node(item_1, item_2);
-            }
-            item_2 = item_1;
-            item_1 = item_1->prev;
-        }
-        extract_node(min_max);
-        insert_node(head_stop, min_max, -1);
-        head_stop = min_max;
+    DllNode *prev = list->head;
+    for (i = 0; i < size; ++i)
+    {
+        nodes[i]->data = data[i];
+        nodes[i]->prev = prev;
+        prev->next = nodes[i];
+        prev = nodes[i];
     }
+    prev->next = list->tail;
+    list->tail->prev = prev;
+
+    free(nodes);
+    free(data);
+    return true;
 }
 
-DllNode *merge_sort(DllNode *start, DllNode *end, size_t size, int (*cmp) (const void *, const void *))
+bool dll_compact(DllList *list, size_t data_size)
 {
-    if (size == 1)
-        return start;
+    if (!list || ((data_size > 0) && !list->copy))
+        return false;
 
-    size_t left_part_size = size / 2;
-    size_t right_part_size = size - left_part_size;
-
-    // Find the initial node of the right side and last node
-    // of the left side
-    DllNode *left_part_end = NULL;
-    DllNode *right_part_start = start;
-    for (int i = 0; i < left_part_size; ++i)
-        right_part_start = right_part_start->next;
-    left_part_end = right_part_start->prev;
-
-    // Recursivery sort the right and left parts
-    DllNode *left_part = merge_sort(start, left_part_end, left_part_size, cmp);
-    DllNode *right_part = merge_sort(right_part_start, end, right_part_size, cmp);
-
-    // Pointers to the start and end nodes of the combined left and right parts
-    DllNode *unity_start = NULL;
-    DllNode *unity_end = NULL;
-
-    // Combaine the left and the right parts
-    for (int i = 0; i < size; ++i)
-    {
-        // If the length of the right or left part is zero,
-        // then we add the remaining part without any additional checks
-        if (left_part_size == 0)
-        {
-            unity_end->next = right_part;
-            unity_end = right_part;
-            right_part = right_part->next;
-            continue;
-        }
-        if (right_part_size == 0)
-        {
-            unity_end->next = left_part;
-            unity_end = left_part;
-            left_part = left_part->next;
-            continue;
-        }
+    // The elements of a deque are already stored contiguously.
+    if ((list->size == 0) || list->ring)
+        return true;
+
+    // The payloads start at the first suitably aligned address after the nodes.
+    size_t alignment = _Alignof(max_align_t);
+    size_t size = list->size;
+    size_t payload_offset = sizeof(DllBlock) + size * sizeof(DllNode);
+    payload_offset = (payload_offset + alignment - 1) / alignment * alignment;
+
+    DllBlock *block = malloc(payload_offset + size * data_size);
+    if (!block)
+        return false;
+    if (!reserve_blocks(list, 1))
+    {
+        free(block);
+        return false;
+    }
+
+    char *payload = (char *) block + payload_offset;
+    block->free_nodes = NULL;
+    block->live = (data_size > 0) ? 2 * size : size;
+    block->end = (uintptr_t) (payload + size * data_size);
+    insert_block(list, block);
+
+    DllIndexEntry *entry = list->index ? list->index->next[0] : NULL;
+    DllNode *prev = list->head;
+    DllNode *cur = list->head->next;
+    DllNode *next = NULL;
+    DllNode *new_node = NULL;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        next = cur->next;
+        new_node = &block->nodes[i];
+        new_node->data = cur->data;
 
-        // We using the comparison function to find the smallest element
-        // and add it to the end of the united part.
-        if (cmp(left_part->data, right_part->data) == -1)
+        if (data_size > 0)
         {
-            if (i == 0)
-                unity_start = left_part;
-            else
-                unity_end->next = left_part;
-            unity_end = left_part;
-            left_part = left_part->next;
-            --left_part_size;
+            new_node->data = memcpy(payload + i * data_size, cur->data, data_size);
+            drop_data(list, cur->data);
         }
-        else
+
+        // The towers of the index are visited in list order.
+        if (entry && (entry->node == cur))
         {
-            if (i == 0)
-                unity_start = right_part;
-            else
-                unity_end->next = right_part;
-            unity_end = right_part;
-            right_part = right_part->next;
-            --right_part_size;
+            entry->node = new_node;
+            entry = entry->next[0];
         }
-    }
 
-    return unity_start;
-}
+        new_node->prev = prev;
+        prev->next = new_node;
+        prev = new_node;
 
-void dll_sort(DllList *list, int (*cmp) (const void *, const void *))
-{
-    if (!list || list->size < 2)
-        return;
+        free_node(list, cur);
+        cur = next;
+    }
+    prev->next = list->tail;
+    list->tail->prev = prev;
 
-    DllNode *sorted_list_start = merge_sort(list->head->next, list->tail->prev, list->size, cmp);
-    sorted_list_start->prev = list->head;
-    list->head->next = sorted_list_start;
+    if (list->index)
+        index_remap_towers(list->index);
 
-    DllNode *sorted_list_end = sorted_list_start;
-    DllNode *temp = NULL;
-    int iter = list->size - 1;
-    for (int i = 0; i < iter; ++i)
-    {
-        temp = sorted_list_end;
-        sorted_list_end = sorted_list_end->next;
-        sorted_list_end->prev = temp;
-    }
-    sorted_list_end->next = list->tail;
-    list->tail->prev = sorted_list_end;
+    return true;
 }
@@ -0,0 +1,411 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <doubly_linked_list_pipeline.h>
+
+/*
+ * @brief: Bounded queue of chains between two stages.
+ *
+ * The slots are lists created once with the queue, a chain is spliced into
+ * a free slot and out of it again, so passing a chain allocates nothing.
+ */
+typedef struct {
+    DllList **slots;            ///< Circular array of chains.
+    size_t capacity;            ///< Number of slots.
+    size_t first;               ///< Slot of the oldest chain.
+    size_t count;               ///< Number of chains in the queue.
+    bool closed;                ///< No more chains are accepted once set.
+    pthread_mutex_t lock;       ///< Protects the fields above.
+    pthread_cond_t not_empty;   ///< Signaled when a chain is added or the queue is closed.
+    pthread_cond_t not_full;    ///< Signaled when a chain is taken or the queue is closed.
+} DllQueue;
+
+typedef enum {
+    DLL_STAGE_MAP,
+    DLL_STAGE_FILTER,
+    DLL_STAGE_BATCH
+} DllStageKind;
+
+typedef struct {
+    DllStageKind kind;                      ///< What the stage does with a chain.
+    void (*func) (void *, void *);          ///< Function of a map stage.
+    bool (*keep) (const void *, void *);    ///< Predicate of a filter stage.
+    void *arg;                              ///< User data of 'func' or 'keep'.
+    size_t batch_size;                      ///< Chain size of a batch stage.
+    DllQueue *input;                        ///< Queue the stage reads from.
+    DllQueue *output;                       ///< Queue the stage writes to.
+    DllPipeline *pipeline;                  ///< Pipeline the stage belongs to.
+    pthread_t thread;                       ///< Thread running the stage.
+} DllStage;
+
+struct DllPipeline {
+    void *(*copy)(const void *);    ///< Function to copy data.
+    void (*destroy)(void *);        ///< Function to delete data.
+    size_t queue_capacity;          ///< Number of slots of each queue.
+    DllStage *stages;               ///< Stages in the order elements pass them.
+    size_t stages_count;            ///< Number of stages.
+    DllQueue *queues;               ///< 'stages_count + 1' queues once started, NULL before.
+    size_t threads_count;           ///< Number of stage threads running.
+};
+
+/*
+ * @brief: Initializes a queue with empty slots.
+ *
+ * @return: 'true' on success, 'false' on failure.
+ */
+static bool queue_init(DllQueue *queue, const DllPipeline *pipeline)
+{
+    queue->capacity = pipeline->queue_capacity;
+    queue->first = 0;
+    queue->count = 0;
+    queue->closed = false;
+
+    queue->slots = calloc(queue->capacity, sizeof(DllList *));
+    if (!queue->slots)
+        return false;
+
+    size_t created = 0;
+    for (; created < queue->capacity; ++created)
+    {
+        queue->slots[created] = dll_create(pipeline->copy, pipeline->destroy);
+        if (!queue->slots[created])
+            goto slots_error;
+    }
+
+    if (pthread_mutex_init(&queue->lock, NULL) != 0)
+        goto slots_error;
+    if (pthread_cond_init(&queue->not_empty, NULL) != 0)
+        goto not_empty_error;
+    if (pthread_cond_init(&queue->not_full, NULL) != 0)
+        goto not_full_error;
+
+    return true;
+
+    not_full_error:
+        pthread_cond_destroy(&queue->not_empty);
+    not_empty_error:
+        pthread_mutex_destroy(&queue->lock);
+    slots_error:
+        while (created > 0)
+            dll_destroy(queue->slots[--created]);
+        free(queue->slots);
+    return false;
+}
+
+/*
+ * @brief: Frees a queue and the elements still in it.
+ */
+static void queue_free(DllQueue *queue)
+{
+    for (size_t i = 0; i < queue->capacity; ++i)
+        dll_destroy(queue->slots[i]);
+    free(queue->slots);
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+/*
+ * @brief: Moves all the elements of a list into the queue as one chain.
+ *
+ * Blocks while the queue is full. The list must not be in deque mode, so
+ * that the splice is O(1) and cannot fail.
+ *
+ * @return: 'true' on success, 'false' if the queue is closed (the list is unchanged).
+ */
+static bool queue_put(DllQueue *queue, DllList *items)
+{
+    pthread_mutex_lock(&queue->lock);
+    while ((queue->count == queue->capacity) && !queue->closed)
+        pthread_cond_wait(&queue->not_full, &queue->lock);
+
+    bool result = !queue->closed;
+    if (result)
+    {
+        size_t slot = (queue->first + queue->count) % queue->capacity;
+        result = dll_splice_front(queue->slots[slot], items, SIZE_MAX);
+    }
+    if (result)
+    {
+        ++queue->count;
+        pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+/*
+ * @brief: Moves the oldest chain of the queue to the back of a list.
+ *
+ * Blocks while the queue is empty and not closed. The list must be neither
+ * in deque mode nor limited by a capacity, so that the splice is O(1) and
+ * cannot fail.
+ *
+ * @return: 'true' on success, 'false' if the queue is closed and empty.
+ */
+static bool queue_take(DllQueue *queue, DllList *out)
+{
+    pthread_mutex_lock(&queue->lock);
+    while ((queue->count == 0) && !queue->closed)
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+
+    bool result = (queue->count > 0) &&
+            dll_splice_front(out, queue->slots[queue->first], SIZE_MAX);
+    if (result)
+    {
+        queue->first = (queue->first + 1) % queue->capacity;
+        --queue->count;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return result;
+}
+
+/*
+ * @brief: Stops accepting chains and wakes every thread waiting on the queue.
+ */
+static void queue_close(DllQueue *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/*
+ * @brief: Passes a chain to the next stage, or drops it if that is not possible.
+ */
+static void emit(DllStage *stage, DllList *chain)
+{
+    if (!dll_is_empty(chain) && !queue_put(stage->output, chain))
+        dll_clear(chain);
+}
+
+/*
+ * @brief: Body of a stage thread.
+ *
+ * Takes chains from the input queue until it is closed and drained, then
+ * closes the output queue so that the next stage finishes in turn.
+ */
+static void *run_stage(void *arg)
+{
+    DllStage *stage = arg;
+    DllList *chain = dll_create(stage->pipeline->copy, stage->pipeline->destroy);
+    DllList *out = dll_create(stage->pipeline->copy, stage->pipeline->destroy);
+
+    while (chain && out && queue_take(stage->input, chain))
+    {
+        switch (stage->kind)
+        {
+        case DLL_STAGE_MAP:
+            dll_for_each(chain, stage->func, stage->arg);
+            emit(stage, chain);
+            break;
+        case DLL_STAGE_FILTER:
+            // The kept elements are relinked one by one, the others released.
+            while (!dll_is_empty(chain))
+            {
+                if (stage->keep(dll_get_at(chain, 0), stage->arg))
+                    dll_splice_front(out, chain, 1);
+                else
+                    dll_remove_at(chain, 0);
+            }
+            emit(stage, out);
+            break;
+        case DLL_STAGE_BATCH:
+            dll_splice_front(out, chain, SIZE_MAX);
+            while (dll_size(out) >= stage->batch_size)
+            {
+                dll_splice_front(chain, out, stage->batch_size);
+                emit(stage, chain);
+            }
+            break;
+        }
+    }
+
+    // Flush the last partial batch.
+    if (out)
+        emit(stage, out);
+
+    // Closing the input as well unblocks the previous stage if this one failed.
+    queue_close(stage->input);
+    queue_close(stage->output);
+    dll_destroy(out);
+    dll_destroy(chain);
+
+    return NULL;
+}
+
+/*
+ * @brief: Stops the stage threads and frees the queues.
+ */
+static void stop(DllPipeline *pipeline, size_t queues_count)
+{
+    for (size_t i = 0; i < queues_count; ++i)
+        queue_close(&pipeline->queues[i]);
+    for (size_t i = 0; i < pipeline->threads_count; ++i)
+        pthread_join(pipeline->stages[i].thread, NULL);
+    for (size_t i = 0; i < queues_count; ++i)
+        queue_free(&pipeline->queues[i]);
+
+    free(pipeline->queues);
+    pipeline->queues = NULL;
+    pipeline->threads_count = 0;
+}
+
+/*
+ * @brief: Appends a stage to a pipeline that is not started yet.
+ *
+ * @return: Pointer to the new stage, or NULL on failure.
+ */
+static DllStage *add_stage(DllPipeline *pipeline, DllStageKind kind)
+{
+    if (!pipeline || pipeline->queues)
+        return NULL;
+
+    DllStage *stages = realloc(pipeline->stages,
+            (pipeline->stages_count + 1) * sizeof(DllStage));
+    if (!stages)
+        return NULL;
+    pipeline->stages = stages;
+
+    DllStage *stage = &stages[pipeline->stages_count++];
+    *stage = (DllStage) { .kind = kind, .pipeline = pipeline };
+    return stage;
+}
+
+DllPipeline *dll_pipeline_create(void *(*copy)(const void *), void (*destroy)(void *),
+        size_t queue_capacity)
+{
+    if ((!copy && destroy) || (copy && !destroy) || (queue_capacity == 0))
+        return NULL;
+
+    DllPipeline *pipeline = calloc(1, sizeof(DllPipeline));
+    if (!pipeline)
+        return NULL;
+
+    pipeline->copy = copy;
+    pipeline->destroy = destroy;
+    pipeline->queue_capacity = queue_capacity;
+
+    return pipeline;
+}
+
+bool dll_pipeline_add_map(DllPipeline *pipeline, void (*func) (void *, void *), void *arg)
+{
+    if (!func)
+        return false;
+
+    DllStage *stage = add_stage(pipeline, DLL_STAGE_MAP);
+    if (!stage)
+        return false;
+
+    stage->func = func;
+    stage->arg = arg;
+    return true;
+}
+
+bool dll_pipeline_add_filter(DllPipeline *pipeline, bool (*keep) (const void *, void *), void *arg)
+{
+    if (!keep)
+        return false;
+
+    DllStage *stage = add_stage(pipeline, DLL_STAGE_FILTER);
+    if (!stage)
+        return false;
+
+    stage->keep = keep;
+    stage->arg = arg;
+    return true;
+}
+
+bool dll_pipeline_add_batch(DllPipeline *pipeline, size_t batch_size)
+{
+    if (batch_size == 0)
+        return false;
+
+    DllStage *stage = add_stage(pipeline, DLL_STAGE_BATCH);
+    if (!stage)
+        return false;
+
+    stage->batch_size = batch_size;
+    return true;
+}
+
+bool dll_pipeline_start(DllPipeline *pipeline)
+{
+    if (!pipeline || pipeline->queues)
+        return false;
+
+    pipeline->queues = calloc(pipeline->stages_count + 1, sizeof(DllQueue));
+    if (!pipeline->queues)
+        return false;
+
+    size_t queues_count = 0;
+    for (; queues_count <= pipeline->stages_count; ++queues_count)
+    {
+        if (!queue_init(&pipeline->queues[queues_count], pipeline))
+            goto error;
+    }
+
+    for (size_t i = 0; i < pipeline->stages_count; ++i)
+    {
+        DllStage *stage = &pipeline->stages[i];
+        stage->input = &pipeline->queues[i];
+        stage->output = &pipeline->queues[i + 1];
+        if (pthread_create(&stage->thread, NULL, run_stage, stage) != 0)
+            goto error;
+        ++pipeline->threads_count;
+    }
+
+    return true;
+
+    error:
+        stop(pipeline, queues_count);
+    return false;
+}
+
+bool dll_pipeline_push(DllPipeline *pipeline, DllList *items)
+{
+    if (!pipeline || !pipeline->queues || !items || items->blocks || items->ring ||
+            (items->copy != pipeline->copy) || (items->destroy != pipeline->destroy))
+        return false;
+
+    if (dll_is_empty(items))
+        return true;
+
+    return queue_put(&pipeline->queues[0], items);
+}
+
+bool dll_pipeline_close(DllPipeline *pipeline)
+{
+    if (!pipeline || !pipeline->queues)
+        return false;
+
+    queue_close(&pipeline->queues[0]);
+    return true;
+}
+
+bool dll_pipeline_pop(DllPipeline *pipeline, DllList *out)
+{
+    // A refused chain would be indistinguishable from the end of the stream.
+    if (!pipeline || !pipeline->queues || !out || out->ring || (out->capacity > 0) ||
+            (out->copy != pipeline->copy) || (out->destroy != pipeline->destroy))
+        return false;
+
+    return queue_take(&pipeline->queues[pipeline->stages_count], out);
+}
+
+void dll_pipeline_destroy(DllPipeline *pipeline)
+{
+    if (!pipeline)
+        return;
+
+    if (pipeline->queues)
+        stop(pipeline, pipeline->stages_count + 1);
+    free(pipeline->stages);
+    free(pipeline);
+}